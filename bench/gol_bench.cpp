@@ -0,0 +1,222 @@
+#include "engine/board.hpp"
+#include "engine/engine.hpp"
+
+#include <docopt/docopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+// windows.h has to come first
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string const g_usage = R"(gol_bench
+
+Usage:
+    gol_bench [-h | --help]
+              [--workload=<name>]
+              [--engine=<name>]
+              [--max-threads=<n>]
+              [--pin-threads]
+
+Options:
+    -h --help               Show this screen.
+    --workload=<name>       Only run the workload with this name.
+    --engine=<name>         Only run the engine with this name.
+    --max-threads=<n>       Highest thread count tried for multithreaded engines, 0 for all cores [default: 0].
+    --pin-threads           Pin every thread of multithreaded engines to its own core.
+)";
+
+struct workload
+{
+    std::string name;
+    int width = 0;
+    int height = 0;
+    int generations = 0;
+    std::function<void(gol::board&)> setup;
+};
+
+auto place(gol::board& b, std::vector<std::string> const& rows, int const x0, int const y0) -> void
+{
+    for(std::size_t y = 0; y < rows.size(); ++y) {
+        for(std::size_t x = 0; x < rows[y].size(); ++x) {
+            if(rows[y][x] == 'O') {
+                b.at(x0 + static_cast<int>(x), y0 + static_cast<int>(y)) = gol::board::s_alive;
+            }
+        }
+    }
+}
+
+// mt19937_64's output is fixed by the standard, unlike the distributions, so soups are the same everywhere
+auto random_fill(gol::board& b) -> void
+{
+    constexpr std::uint64_t seed = 42;
+    std::mt19937_64 rng{ seed };
+
+    for(int y = 0; y < b.height(); ++y) {
+        for(int x = 0; x < b.width(); ++x) {
+            b.at(x, y) = static_cast<unsigned char>(rng() & 1U);
+        }
+    }
+}
+
+[[nodiscard]] auto workloads() -> std::vector<workload>
+{
+    constexpr int small = 512;
+    constexpr int medium = 2048;
+    constexpr int large = 8192;
+    constexpr int gun_board = 256;
+
+    return {
+        { "r-pentomino", small, small, 1103,
+          [](gol::board& b) { place(b, { ".OO", "OO.", ".O." }, b.width() / 2, b.height() / 2); } },
+        { "gosper-gun", gun_board, gun_board, 100000,
+          [](gol::board& b) {
+              place(b,
+                    { "........................O...........",
+                      "......................O.O...........",
+                      "............OO......OO............OO",
+                      "...........O...O....OO............OO",
+                      "OO........O.....O...OO..............",
+                      "OO........O...O.OO....O.O...........",
+                      "..........O.....O.......O...........",
+                      "...........O...O....................",
+                      "............OO......................" },
+                    1,
+                    1);
+          } },
+        { "soup-512", small, small, 1000, random_fill },
+        { "soup-2048", medium, medium, 100, random_fill },
+        { "soup-8192", large, large, 10, random_fill },
+        { "empty-2048", medium, medium, 100, [](gol::board&) {} },
+    };
+}
+
+// Resident memory right now, -1 where it can't be found out. Unlike the peak it goes down again once a workload's
+// boards are freed, so every run gets a number of its own.
+[[nodiscard]] auto rss_kb() -> long
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return static_cast<long>(counters.WorkingSetSize / 1024);
+#elif defined(__linux__)
+    constexpr long bytes_per_kb = 1024;
+    std::ifstream statm{ "/proc/self/statm" };
+    long size = 0;
+    long resident = 0;
+
+    if(!(statm >> size >> resident)) {
+        return -1;
+    }
+
+    return resident * (sysconf(_SC_PAGESIZE) / bytes_per_kb);
+#else
+    return -1;
+#endif
+}
+
+[[nodiscard]] auto thread_counts(std::size_t max_threads) -> std::vector<std::size_t>
+{
+    if(max_threads == 0) {
+        max_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    std::vector<std::size_t> counts;
+
+    for(std::size_t n = 1; n < max_threads; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max_threads);
+
+    return counts;
+}
+
+[[nodiscard]] auto run(workload const& w, gol::engine& e, std::size_t const num_threads) -> std::string
+{
+    auto current = e.make_board(w.width, w.height);
+    auto next = e.make_board(w.width, w.height);
+
+    w.setup(current);
+
+    auto const start = std::chrono::steady_clock::now();
+
+    for(int i = 0; i < w.generations; ++i) {
+        e.step(current, next);
+        std::swap(current, next);
+    }
+
+    auto const end = std::chrono::steady_clock::now();
+    // with both boards still allocated
+    auto const resident = rss_kb();
+    auto const seconds = std::chrono::duration<double>(end - start).count();
+    auto const ns = std::chrono::duration<double, std::nano>(end - start).count();
+    auto const cells = static_cast<double>(w.width) * static_cast<double>(w.height) * w.generations;
+
+    std::ostringstream ss;
+    ss << R"({"workload":")" << w.name << R"(","engine":")" << e.name() << R"(","threads":)" << num_threads
+       << R"(,"width":)" << w.width << R"(,"height":)" << w.height << R"(,"generations":)" << w.generations
+       << R"(,"seconds":)" << seconds << R"(,"generations_per_second":)" << w.generations / seconds
+       << R"(,"cells_per_ns":)" << cells / ns << R"(,"rss_kb":)" << resident << R"(,"population":)"
+       << current.population() << R"(,"hash":")" << std::hex << current.hash() << std::dec << R"("})";
+
+    return ss.str();
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto args = docopt::docopt(g_usage, { argv + 1, argv + argc }, /*show help:*/ true, "gol_bench");
+
+    auto const only_workload = args["--workload"].isString() ? args["--workload"].asString() : std::string{};
+    auto const only_engine = args["--engine"].isString() ? args["--engine"].asString() : std::string{};
+    std::size_t const max_threads = std::stoul(args["--max-threads"].asString());
+    bool const pin_threads = args["--pin-threads"].isBool() && args["--pin-threads"].asBool();
+
+    bool first = true;
+    std::cout << "{\"results\":[\n";
+
+    for(auto const& w : workloads()) {
+        if(!only_workload.empty() && w.name != only_workload) {
+            continue;
+        }
+
+        for(auto const& name : gol::available_engines()) {
+            if(!only_engine.empty() && name != only_engine) {
+                continue;
+            }
+
+            for(auto const num_threads : thread_counts(max_threads)) {
+                auto e = gol::make_engine(name, num_threads, pin_threads);
+
+                if(!e->multithreaded() && num_threads > 1) {
+                    break;
+                }
+
+                std::cout << (first ? "" : ",\n") << run(w, *e, e->multithreaded() ? num_threads : 1) << std::flush;
+                first = false;
+            }
+        }
+    }
+
+    std::cout << "\n]}\n";
+}
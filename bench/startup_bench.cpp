@@ -0,0 +1,143 @@
+#include "engine/bit_grid.hpp"
+#include "engine/board.hpp"
+#include "engine/change_set.hpp"
+#include "engine/density_pyramid.hpp"
+#include "engine/engine.hpp"
+
+#include <docopt/docopt.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+// windows.h has to come first
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+std::string const g_usage = R"(startup_bench
+
+Usage:
+    startup_bench [-h | --help] [--width=<w>] [--height=<h>] [--engine=<name>] [--cells=<n>]
+
+Options:
+    -h --help           Show this screen.
+    --width=<w>         Board width [default: 10000].
+    --height=<h>        Board height [default: 10000].
+    --engine=<name>     Engine the simulation boards are made for [default: parallel].
+    --cells=<n>         Cells set in the preview before the simulation starts [default: 10000].
+)";
+
+using clock_type = std::chrono::steady_clock;
+
+[[nodiscard]] auto peak_rss_kb() noexcept -> long
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#endif
+}
+
+class stopwatch
+{
+private:
+    clock_type::time_point m_start = clock_type::now();
+    clock_type::time_point m_last = m_start;
+
+public:
+    auto lap(char const* name) -> void
+    {
+        auto const now = clock_type::now();
+        std::cout << "    " << name << ": " << std::chrono::duration<double, std::milli>(now - m_last).count()
+                  << " ms\n";
+        m_last = now;
+    }
+
+    [[nodiscard]] auto total_ms() const -> double
+    {
+        return std::chrono::duration<double, std::milli>(m_last - m_start).count();
+    }
+};
+
+} // namespace
+
+// Everything that happens on the CPU between the window opening and the first generation, in the order the view and
+// the simulation scene do it, without the OpenGL calls
+auto main(int argc, char* argv[]) -> int
+{
+    auto args = docopt::docopt(g_usage, { argv + 1, argv + argc }, /*show help:*/ true, "startup_bench");
+
+    int const w = std::stoi(args["--width"].asString());
+    int const h = std::stoi(args["--height"].asString());
+    int const num_cells = std::stoi(args["--cells"].asString());
+
+    auto e = gol::make_engine(args["--engine"].asString(), std::max(1U, std::thread::hardware_concurrency()));
+    if(e == nullptr) {
+        std::cerr << "Unknown engine: " << args["--engine"].asString() << '\n';
+        return 1;
+    }
+
+    std::cout << w << 'x' << h << " board, " << e->name() << " engine, " << num_cells << " initial cells\n";
+
+    stopwatch watch;
+
+    // view
+    gol::bit_grid initial{ w, h };
+    gol::change_set pending{ w, h };
+    gol::density_pyramid pyramid{ w, h };
+    watch.lap("view state");
+
+    constexpr std::uint64_t seed = 42;
+    std::mt19937_64 rng{ seed };
+    for(int i = 0; i < num_cells; ++i) {
+        auto const x = static_cast<int>(rng() % static_cast<std::uint64_t>(w));
+        auto const y = static_cast<int>(rng() % static_cast<std::uint64_t>(h));
+
+        if(!initial.test(x, y)) {
+            initial.set(x, y);
+            pyramid.add(x, y, 1);
+        }
+    }
+    watch.lap("preview edits");
+
+    // simulation scene
+    gol::board grid{ w, h };
+    initial.copy_to(grid);
+    auto sim_grid = e->make_board(w, h);
+    initial.copy_to(sim_grid);
+    auto next = e->make_board(w, h);
+    gol::change_set changes{ w, h };
+    watch.lap("scene boards");
+
+    std::array<gol::board, 3> snapshots;
+    for(auto& s : snapshots) {
+        s = gol::board{ w, h };
+    }
+    watch.lap("snapshot buffers");
+
+    double const startup_ms = watch.total_ms();
+
+    e->step(sim_grid, next);
+    watch.lap("first generation");
+
+    std::cout << "startup: " << startup_ms << " ms, peak rss: " << peak_rss_kb() / 1024 << " MB, population "
+              << next.population() << '\n';
+
+    return 0;
+}
@@ -0,0 +1,439 @@
+#include "census.hpp"
+
+#include "assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <future>
+#include <limits>
+#include <utility>
+
+namespace {
+
+struct known_object
+{
+    char const* name;
+    std::vector<std::string> rows;
+};
+
+// cells closer than this (chebyshev distance) belong to the same object, 1 would split spaceships like the LWSS
+constexpr int g_object_radius = 2;
+
+[[nodiscard]] auto known_objects() -> std::vector<known_object>
+{
+    return {
+        { "block", { "OO", "OO" } },
+        { "blinker", { "OOO" } },
+        { "beehive", { ".OO.", "O..O", ".OO." } },
+        { "loaf", { ".OO.", "O..O", ".O.O", "..O." } },
+        { "boat", { "OO.", "O.O", ".O." } },
+        { "ship", { "OO.", "O.O", ".OO" } },
+        { "tub", { ".O.", "O.O", ".O." } },
+        { "pond", { ".OO.", "O..O", "O..O", ".OO." } },
+        { "long boat", { "OO..", "O.O.", ".O.O", "..O." } },
+        { "barge", { ".O..", "O.O.", ".O.O", "..O." } },
+        { "mango", { ".OO..", "O..O.", ".O..O", "..OO." } },
+        { "eater", { "OO..", "O.O.", "..O.", "..OO" } },
+        { "toad", { ".OOO", "OOO." } },
+        { "beacon", { "OO..", "OO..", "..OO", "..OO" } },
+        { "pentadecathlon", { "..O....O..", "OO.OOOO.OO", "..O....O.." } },
+        { "glider", { ".O.", "..O", "OOO" } },
+        { "lwss", { ".O..O", "O....", "O...O", "OOOO." } },
+        { "mwss", { "...O..", ".O...O", "O.....", "O....O", "OOOOO." } },
+        { "hwss", { "...OO..", ".O....O", "O......", "O.....O", "OOOOOO." } },
+    };
+}
+
+[[nodiscard]] auto from_rows(std::vector<std::string> const& rows) -> std::vector<gol::coord>
+{
+    std::vector<gol::coord> cells;
+
+    for(std::size_t y = 0; y < rows.size(); ++y) {
+        for(std::size_t x = 0; x < rows[y].size(); ++x) {
+            if(rows[y][x] == 'O') {
+                cells.push_back({ static_cast<int>(x), static_cast<int>(y) });
+            }
+        }
+    }
+
+    return cells;
+}
+
+[[nodiscard]] auto min_corner(std::vector<gol::coord> const& cells) noexcept -> gol::coord
+{
+    gol::coord corner = { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+
+    for(auto const& c : cells) {
+        corner.x = std::min(corner.x, c.x);
+        corner.y = std::min(corner.y, c.y);
+    }
+
+    return corner;
+}
+
+// translate so that the bounding box starts at (0, 0) and sort, making equal shapes compare equal
+[[nodiscard]] auto normalize(std::vector<gol::coord> cells) -> std::vector<gol::coord>
+{
+    auto const corner = min_corner(cells);
+
+    for(auto& c : cells) {
+        c.x -= corner.x;
+        c.y -= corner.y;
+    }
+
+    std::sort(cells.begin(), cells.end());
+
+    return cells;
+}
+
+// smallest normalized form among the 8 rotations/reflections
+[[nodiscard]] auto canonicalize(std::vector<gol::coord> const& cells) -> std::vector<gol::coord>
+{
+    std::vector<gol::coord> best;
+    std::vector<gol::coord> transformed(cells.size());
+
+    for(int symmetry = 0; symmetry < 8; ++symmetry) {
+        for(std::size_t i = 0; i < cells.size(); ++i) {
+            int x = cells[i].x;
+            int y = cells[i].y;
+
+            if((symmetry & 1) != 0) {
+                x = -x;
+            }
+            if((symmetry & 2) != 0) {
+                y = -y;
+            }
+            if((symmetry & 4) != 0) {
+                std::swap(x, y);
+            }
+
+            transformed[i] = { x, y };
+        }
+
+        auto candidate = normalize(transformed);
+
+        if(best.empty() || candidate < best) {
+            best = std::move(candidate);
+        }
+    }
+
+    return best;
+}
+
+// FNV-1a over the cell coordinates
+[[nodiscard]] auto hash(std::vector<gol::coord> const& cells) noexcept -> std::uint64_t
+{
+    constexpr std::uint64_t offset_basis = 14695981039346656037ULL;
+    constexpr std::uint64_t prime = 1099511628211ULL;
+
+    std::uint64_t h = offset_basis;
+
+    for(auto const& c : cells) {
+        for(int const v : { c.x, c.y }) {
+            h ^= static_cast<std::uint64_t>(static_cast<std::uint32_t>(v));
+            h *= prime;
+        }
+    }
+
+    return h;
+}
+
+// one generation of an object simulated on its own under `r`, on an unbounded plane
+[[nodiscard]] auto step(std::vector<gol::coord> const& cells, gol::rule const& r) -> std::vector<gol::coord>
+{
+    if(cells.empty()) {
+        return {};
+    }
+
+    auto const corner = min_corner(cells);
+    int max_x = corner.x;
+    int max_y = corner.y;
+
+    for(auto const& c : cells) {
+        max_x = std::max(max_x, c.x);
+        max_y = std::max(max_y, c.y);
+    }
+
+    // one cell of margin on every side for births, one more so neighbors never go out of bounds
+    int const width = max_x - corner.x + 5;
+    int const height = max_y - corner.y + 5;
+    auto const index = [width](int const x, int const y) {
+        return static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x);
+    };
+
+    std::vector<unsigned char> grid(static_cast<std::size_t>(width) * static_cast<std::size_t>(height), 0);
+
+    for(auto const& c : cells) {
+        grid[index(c.x - corner.x + 2, c.y - corner.y + 2)] = 1;
+    }
+
+    std::vector<gol::coord> next;
+
+    for(int y = 1; y < height - 1; ++y) {
+        for(int x = 1; x < width - 1; ++x) {
+            int count = 0;
+
+            for(int dy = -1; dy <= 1; ++dy) {
+                for(int dx = -1; dx <= 1; ++dx) {
+                    count += grid[index(x + dx, y + dy)];
+                }
+            }
+
+            bool const alive = grid[index(x, y)] != 0;
+            count -= static_cast<int>(alive);
+
+            auto const mask = alive ? r.survive : r.birth;
+            if((mask & (1U << static_cast<unsigned>(count))) != 0) {
+                next.push_back({ x + corner.x - 2, y + corner.y - 2 });
+            }
+        }
+    }
+
+    return next;
+}
+
+// the root of i, halving the path on the way so chains don't grow with every union
+[[nodiscard]] auto find(std::vector<int>& parent, int i) noexcept -> int
+{
+    while(parent[static_cast<std::size_t>(i)] != i) {
+        auto& up = parent[static_cast<std::size_t>(i)];
+        up = parent[static_cast<std::size_t>(up)];
+        i = up;
+    }
+
+    return i;
+}
+
+auto unite(std::vector<int>& parent, int const a, int const b) noexcept -> void
+{
+    auto const root_a = find(parent, a);
+    auto const root_b = find(parent, b);
+
+    // always link to the smaller root so the result doesn't depend on the order of unions
+    if(root_a < root_b) {
+        parent[static_cast<std::size_t>(root_b)] = root_a;
+    }
+    else if(root_b < root_a) {
+        parent[static_cast<std::size_t>(root_a)] = root_b;
+    }
+}
+
+// unite every live cell of rows [y_begin, y_end) with the live cells before it in scan order, without leaving the rows
+auto unite_rows(std::vector<unsigned char> const& grid,
+                std::vector<int>& parent,
+                int const width,
+                int const y_begin,
+                int const y_end) noexcept -> void
+{
+    for(int y = y_begin; y < y_end; ++y) {
+        for(int x = 0; x < width; ++x) {
+            int const i = y * width + x;
+
+            if(grid[static_cast<std::size_t>(i)] == 0) {
+                continue;
+            }
+
+            for(int dy = -g_object_radius; dy <= 0; ++dy) {
+                int const ny = y + dy;
+
+                if(ny < y_begin) {
+                    continue;
+                }
+
+                for(int dx = -g_object_radius; dx <= g_object_radius; ++dx) {
+                    int const nx = x + dx;
+
+                    if(dy == 0 && dx >= 0) {
+                        break;
+                    }
+                    if(nx < 0 || nx >= width) {
+                        continue;
+                    }
+
+                    int const j = ny * width + nx;
+
+                    if(grid[static_cast<std::size_t>(j)] != 0) {
+                        unite(parent, i, j);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+namespace gol {
+
+census::census(gol::rule const& r)
+    : m_rule{ r }
+    , m_threadpool{ std::max(1U, std::thread::hardware_concurrency()) }
+{
+    if(m_rule != gol::rule{}) {
+        return;
+    }
+
+    for(auto const& object : known_objects()) {
+        this->learn(object.name, from_rows(object.rows));
+    }
+}
+
+auto census::learn(std::string const& name, std::vector<coord> cells) -> void
+{
+    auto const start = normalize(cells);
+
+    // every phase of an oscillator or spaceship maps to the same name
+    for(int i = 0; i < s_max_period; ++i) {
+        m_known.emplace(hash(canonicalize(cells)), name);
+        cells = step(cells, m_rule);
+
+        if(cells.empty() || normalize(cells) == start) {
+            break;
+        }
+    }
+}
+
+auto census::classify(std::vector<coord> const& cells) -> std::string
+{
+    auto const key = hash(canonicalize(cells));
+
+    if(auto const it = m_known.find(key); it != m_known.end()) {
+        return it->second;
+    }
+
+    auto const size = std::to_string(cells.size());
+    auto const start = normalize(cells);
+    auto const start_corner = min_corner(cells);
+    std::string name = "unstable (" + size + " cells)";
+    auto current = cells;
+
+    for(int period = 1; period <= s_max_period; ++period) {
+        current = step(current, m_rule);
+
+        if(current.empty()) {
+            break;
+        }
+
+        if(normalize(current) == start) {
+            if(period == 1) {
+                name = "still life (" + size + " cells)";
+            }
+            else if(min_corner(current) == start_corner) {
+                name = "p" + std::to_string(period) + " oscillator (" + size + " cells)";
+            }
+            else {
+                name = "p" + std::to_string(period) + " spaceship (" + size + " cells)";
+            }
+            break;
+        }
+    }
+
+    m_known.emplace(key, name);
+    return name;
+}
+
+auto census::label(std::vector<unsigned char> const& grid, int const width, int const height)
+    -> std::vector<std::vector<coord>>
+{
+    std::vector<int> parent(grid.size());
+
+    for(std::size_t i = 0; i < parent.size(); ++i) {
+        parent[i] = static_cast<int>(i);
+    }
+
+    auto const num_bands = std::min(static_cast<int>(std::max(1U, std::thread::hardware_concurrency())), height);
+    auto const band_height = (height + num_bands - 1) / num_bands;
+    std::vector<std::future<void>> futures;
+
+    // each band only links and compresses cells inside itself, so the bands never touch the same part of `parent`
+    for(int band_begin = 0; band_begin < height; band_begin += band_height) {
+        int const band_end = std::min(band_begin + band_height, height);
+
+        futures.push_back(m_threadpool.push([&grid, &parent, width, band_begin, band_end] {
+            unite_rows(grid, parent, width, band_begin, band_end);
+        }));
+    }
+
+    for(auto& f : futures) {
+        f.get();
+    }
+
+    // then stitch the bands together along their borders
+    for(int band_begin = band_height; band_begin < height; band_begin += band_height) {
+        for(int y = band_begin; y < std::min(band_begin + g_object_radius, height); ++y) {
+            for(int x = 0; x < width; ++x) {
+                int const i = y * width + x;
+
+                if(grid[static_cast<std::size_t>(i)] == 0) {
+                    continue;
+                }
+
+                for(int ny = std::max(0, y - g_object_radius); ny < band_begin; ++ny) {
+                    for(int nx = std::max(0, x - g_object_radius); nx <= std::min(width - 1, x + g_object_radius);
+                        ++nx) {
+                        int const j = ny * width + nx;
+
+                        if(grid[static_cast<std::size_t>(j)] != 0) {
+                            unite(parent, i, j);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::unordered_map<int, std::size_t> component_of_root;
+    std::vector<std::vector<coord>> components;
+
+    for(int y = 0; y < height; ++y) {
+        for(int x = 0; x < width; ++x) {
+            int const i = y * width + x;
+
+            if(grid[static_cast<std::size_t>(i)] == 0) {
+                continue;
+            }
+
+            auto const [it, inserted] = component_of_root.emplace(find(parent, i), components.size());
+
+            if(inserted) {
+                components.emplace_back();
+            }
+
+            components[it->second].push_back({ x, y });
+        }
+    }
+
+    return components;
+}
+
+auto census::memory_usage(int const width, int const height) noexcept -> std::size_t
+{
+    auto const cells = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    // cells of different objects are further apart than the radius, so no two of them share a block this big
+    auto const block = static_cast<std::size_t>(g_object_radius) + 1;
+    auto const max_objects = ((static_cast<std::size_t>(width) + block - 1) / block) *
+                             ((static_cast<std::size_t>(height) + block - 1) / block);
+    // a vector of cells, and a hash map node and bucket for its root
+    auto const per_object = sizeof(std::vector<coord>) + sizeof(std::pair<int const, std::size_t>) +
+                            3 * sizeof(void*);
+
+    // the union-find parents, then half the cells in vectors that may have grown to twice their size
+    return cells * sizeof(int) + cells * sizeof(coord) + std::min(max_objects, cells / 2) * per_object;
+}
+
+auto census::run(std::vector<unsigned char> const& grid, int const width, int const height)
+    -> std::map<std::string, int>
+{
+    ASSERT(grid.size() == static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+
+    std::map<std::string, int> counts;
+
+    for(auto const& component : this->label(grid, width, height)) {
+        ++counts[this->classify(component)];
+    }
+
+    return counts;
+}
+
+} // namespace gol
@@ -0,0 +1,59 @@
+#ifndef GOL_CENSUS_HPP
+#define GOL_CENSUS_HPP
+#pragma once
+
+#include "coord.hpp"
+
+#include "engine/rule.hpp"
+
+#include "thread/thread_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gol {
+
+// Splits a grid into objects and names them, by their shape or else by how they behave on their own under the rule
+class census
+{
+private:
+    // how many generations an unknown object is simulated on its own to find its period
+    static constexpr int s_max_period = 32;
+
+    gol::rule m_rule;
+    // canonical hash -> object name, seeded with the known objects and grown with every new one
+    std::unordered_map<std::uint64_t, std::string> m_known;
+    gol::threadpool m_threadpool;
+
+    auto learn(std::string const& name, std::vector<coord> cells) -> void;
+    [[nodiscard]] auto classify(std::vector<coord> const& cells) -> std::string;
+    [[nodiscard]] auto label(std::vector<unsigned char> const& grid, int width, int height)
+        -> std::vector<std::vector<coord>>;
+
+public:
+    // The known objects are Life's, so only B3/S23 names them. Under other rules every object is a still life,
+    // oscillator, spaceship or unstable.
+    explicit census(gol::rule const& r = {});
+    census(census const&) = delete;
+    census(census&&) noexcept = delete;
+    ~census() noexcept = default;
+
+    auto operator=(census const&) -> census& = delete;
+    auto operator=(census&&) noexcept -> census& = delete;
+
+    // grid is width * height bytes in row-major order, non-zero meaning alive
+    [[nodiscard]] auto run(std::vector<unsigned char> const& grid, int width, int height)
+        -> std::map<std::string, int>;
+
+    // Most bytes run() allocates on a `width` x `height` grid with up to half of its cells alive, which is far more
+    // than Life boards settle at. The grid itself isn't counted.
+    [[nodiscard]] static auto memory_usage(int width, int height) noexcept -> std::size_t;
+};
+
+} // namespace gol
+
+#endif // !GOL_CENSUS_HPP
@@ -0,0 +1,187 @@
+#include "bit_grid.hpp"
+
+#include <bitset>
+#include <limits>
+
+namespace gol {
+
+bit_grid::bit_grid(int const w, int const h)
+    : m_width{ w }
+    , m_height{ h }
+    , m_words_per_row{ (static_cast<std::size_t>(w) + s_word_bits - 1) / s_word_bits }
+    , m_words(m_words_per_row * static_cast<std::size_t>(h))
+{
+}
+
+auto bit_grid::word(int const x, int const y) noexcept -> std::uint64_t&
+{
+    return m_words[static_cast<std::size_t>(y) * m_words_per_row + static_cast<std::size_t>(x / s_word_bits)];
+}
+
+auto bit_grid::word(int const x, int const y) const noexcept -> std::uint64_t
+{
+    return m_words[static_cast<std::size_t>(y) * m_words_per_row + static_cast<std::size_t>(x / s_word_bits)];
+}
+
+auto bit_grid::bit(int const x) noexcept -> std::uint64_t
+{
+    return std::uint64_t{ 1 } << static_cast<unsigned>(x % s_word_bits);
+}
+
+auto bit_grid::bits_from(int const y, int const from) const noexcept -> std::uint64_t
+{
+    if(from >= m_width || from <= -s_word_bits) {
+        return 0;
+    }
+    if(from < 0) {
+        return this->bits_from(y, 0) << static_cast<unsigned>(-from);
+    }
+
+    auto const* row = &m_words[static_cast<std::size_t>(y) * m_words_per_row];
+    auto const i = static_cast<std::size_t>(from / s_word_bits);
+    auto const shift = static_cast<unsigned>(from % s_word_bits);
+    auto bits = row[i] >> shift; // NOLINT
+
+    if(shift != 0 && i + 1 < m_words_per_row) {
+        bits |= row[i + 1] << (s_word_bits - shift); // NOLINT
+    }
+
+    return bits;
+}
+
+auto bit_grid::assign(int const y,
+                      std::size_t const i,
+                      std::uint64_t const mask,
+                      std::uint64_t const bits,
+                      change_set& changes) noexcept -> void
+{
+    auto& w = m_words[static_cast<std::size_t>(y) * m_words_per_row + i];
+    auto const before = w;
+
+    w = (w & ~mask) | (bits & mask);
+    changes.flip_bits(y, i, before ^ w);
+}
+
+auto bit_grid::width() const noexcept -> int
+{
+    return m_width;
+}
+
+auto bit_grid::height() const noexcept -> int
+{
+    return m_height;
+}
+
+auto bit_grid::test(int const x, int const y) const noexcept -> bool
+{
+    return (this->word(x, y) & bit(x)) != 0;
+}
+
+auto bit_grid::set(int const x, int const y) noexcept -> void
+{
+    this->word(x, y) |= bit(x);
+}
+
+auto bit_grid::reset(int const x, int const y) noexcept -> void
+{
+    this->word(x, y) &= ~bit(x);
+}
+
+auto bit_grid::count() const noexcept -> std::size_t
+{
+    std::size_t n = 0;
+
+    for(auto const w : m_words) {
+        n += std::bitset<s_word_bits>{ w }.count();
+    }
+
+    return n;
+}
+
+auto bit_grid::memory_usage() const noexcept -> std::size_t
+{
+    return m_words.size() * sizeof(std::uint64_t);
+}
+
+auto bit_grid::memory_usage(int const w, int const h) noexcept -> std::size_t
+{
+    return (static_cast<std::size_t>(w) + s_word_bits - 1) / s_word_bits * static_cast<std::size_t>(h) *
+           sizeof(std::uint64_t);
+}
+
+auto bit_grid::fill(int const x0,
+                    int const y0,
+                    int const x1,
+                    int const y1,
+                    bool const alive,
+                    change_set& changes) noexcept -> void
+{
+    std::uint64_t const bits = alive ? ~std::uint64_t{ 0 } : 0;
+    this->for_each_word(
+        x0, y0, x1, y1, [this, bits, &changes](int const y, std::size_t const i, std::uint64_t const mask) {
+            this->assign(y, i, mask, bits, changes);
+        });
+}
+
+auto bit_grid::randomize(int const x0,
+                         int const y0,
+                         int const x1,
+                         int const y1,
+                         double const density,
+                         std::mt19937_64& rng,
+                         change_set& changes) -> void
+{
+    if(density >= 1.0) {
+        this->fill(x0, y0, x1, y1, true, changes);
+        return;
+    }
+
+    // a cell is alive when its draw is below the threshold, comparing raw draws keeps the result portable where
+    // std::bernoulli_distribution isn't
+    auto const threshold = static_cast<std::uint64_t>(std::max(density, 0.0) *
+                                                      static_cast<double>(std::numeric_limits<std::uint64_t>::max()));
+
+    this->for_each_word(
+        x0, y0, x1, y1, [this, threshold, &rng, &changes](int const y, std::size_t const i, std::uint64_t const mask) {
+            std::uint64_t bits = 0;
+
+            for(auto m = mask; m != 0; m &= m - 1) {
+                if(rng() < threshold) {
+                    bits |= std::uint64_t{ 1 } << static_cast<unsigned>(change_set::count_trailing_zeros(m));
+                }
+            }
+
+            this->assign(y, i, mask, bits, changes);
+        });
+}
+
+auto bit_grid::paste(bit_grid const& pattern, int const x, int const y, change_set& changes) noexcept -> void
+{
+    this->for_each_word(x,
+                        y,
+                        x + pattern.width(),
+                        y + pattern.height(),
+                        [this, &pattern, x, y, &changes](int const row, std::size_t const i, std::uint64_t const mask) {
+                            auto const bits = pattern.bits_from(row - y, static_cast<int>(i) * s_word_bits - x);
+                            this->assign(row, i, mask, bits, changes);
+                        });
+}
+
+auto bit_grid::copy_to(board& b) const noexcept -> void
+{
+    this->for_each_set([&b](int const x, int const y) { b.at(x, y) = board::s_alive; });
+}
+
+auto bit_grid::expand_row(int const y, int const x0, int const x1, unsigned char* out) const noexcept -> void
+{
+    for(int x = x0; x < x1; x += s_word_bits) {
+        auto const bits = this->bits_from(y, x);
+        auto const n = std::min(s_word_bits, x1 - x);
+
+        for(int i = 0; i < n; ++i) {
+            out[x - x0 + i] = (bits >> static_cast<unsigned>(i)) & 1U ? board::s_alive : board::s_dead; // NOLINT
+        }
+    }
+}
+
+} // namespace gol
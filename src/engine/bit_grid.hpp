@@ -0,0 +1,125 @@
+#ifndef GOL_ENGINE_BIT_GRID_HPP
+#define GOL_ENGINE_BIT_GRID_HPP
+#pragma once
+
+#include "board.hpp"
+#include "change_set.hpp"
+#include "zeroed_allocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace gol {
+
+// A bit per cell with rows padded to whole 64 bit words, for cell sets that are mostly empty or get built up before
+// the boards exist. A fresh one is all zero pages.
+class bit_grid
+{
+private:
+    static constexpr int s_word_bits = 64;
+
+    int m_width = 0;
+    int m_height = 0;
+    std::size_t m_words_per_row = 0;
+    std::vector<std::uint64_t, zeroed_allocator<std::uint64_t>> m_words;
+
+    [[nodiscard]] auto word(int x, int y) noexcept -> std::uint64_t&;
+    [[nodiscard]] auto word(int x, int y) const noexcept -> std::uint64_t;
+    [[nodiscard]] static auto bit(int x) noexcept -> std::uint64_t;
+    // the 64 cells of row y starting at column `from`, cells outside the grid read as 0
+    [[nodiscard]] auto bits_from(int y, int from) const noexcept -> std::uint64_t;
+    // the cells of word i of row y selected by `mask` become the same bits of `bits`, flips go to `changes`
+    auto assign(int y, std::size_t i, std::uint64_t mask, std::uint64_t bits, change_set& changes) noexcept -> void;
+
+    // calls fn(y, i, mask) for every word of the rows in [y0, y1) that has cells of columns [x0, x1) in it, with
+    // `mask` selecting those cells. The rectangle is clipped to the grid.
+    template<typename Function>
+    auto for_each_word(int x0, int y0, int x1, int y1, Function&& fn) -> void
+    {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, m_width);
+        y1 = std::min(y1, m_height);
+
+        if(x0 >= x1 || y0 >= y1) {
+            return;
+        }
+
+        auto const first = static_cast<std::size_t>(x0 / s_word_bits);
+        auto const last = static_cast<std::size_t>((x1 - 1) / s_word_bits);
+        auto const head = ~std::uint64_t{ 0 } << static_cast<unsigned>(x0 % s_word_bits);
+        auto const tail = ~std::uint64_t{ 0 } >> static_cast<unsigned>(s_word_bits - 1 - (x1 - 1) % s_word_bits);
+
+        for(int y = y0; y < y1; ++y) {
+            for(auto i = first; i <= last; ++i) {
+                auto mask = ~std::uint64_t{ 0 };
+
+                if(i == first) {
+                    mask &= head;
+                }
+                if(i == last) {
+                    mask &= tail;
+                }
+
+                fn(y, i, mask);
+            }
+        }
+    }
+
+public:
+    bit_grid() noexcept = default;
+    bit_grid(bit_grid const&) = default;
+    bit_grid(bit_grid&&) noexcept = default;
+    ~bit_grid() noexcept = default;
+
+    bit_grid(int w, int h);
+
+    auto operator=(bit_grid const&) -> bit_grid& = default;
+    auto operator=(bit_grid&&) noexcept -> bit_grid& = default;
+
+    [[nodiscard]] auto width() const noexcept -> int;
+    [[nodiscard]] auto height() const noexcept -> int;
+
+    [[nodiscard]] auto test(int x, int y) const noexcept -> bool;
+    auto set(int x, int y) noexcept -> void;
+    auto reset(int x, int y) noexcept -> void;
+
+    [[nodiscard]] auto count() const noexcept -> std::size_t;
+    [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+    [[nodiscard]] static auto memory_usage(int w, int h) noexcept -> std::size_t;
+
+    // Bulk edits of the cells in [x0, x1) x [y0, y1), clipped to the grid. They work a word at a time and flip every
+    // cell that changed in `changes` as well, which must be the same size as the grid.
+    auto fill(int x0, int y0, int x1, int y1, bool alive, change_set& changes) noexcept -> void;
+    // every cell is alive with probability `density`, the same seed gives the same cells on every platform
+    auto randomize(int x0, int y0, int x1, int y1, double density, std::mt19937_64& rng, change_set& changes) -> void;
+    // overwrites the cells under `pattern` placed with its top left corner at (x, y), dead cells included
+    auto paste(bit_grid const& pattern, int x, int y, change_set& changes) noexcept -> void;
+
+    // every set cell becomes alive in `b`, the others are left alone
+    auto copy_to(board& b) const noexcept -> void;
+    // cells [x0, x1) of row y to `out` a byte each, board::s_alive or board::s_dead
+    auto expand_row(int y, int x0, int x1, unsigned char* out) const noexcept -> void;
+
+    // calls fn(x, y) for every set cell, row by row, skipping empty words
+    template<typename Function>
+    auto for_each_set(Function&& fn) const -> void
+    {
+        for(int y = 0; y < m_height; ++y) {
+            auto const* row = &m_words[static_cast<std::size_t>(y) * m_words_per_row];
+
+            for(std::size_t i = 0; i < m_words_per_row; ++i) {
+                for(auto bits = row[i]; bits != 0; bits &= bits - 1) { // NOLINT
+                    fn(static_cast<int>(i) * s_word_bits + change_set::count_trailing_zeros(bits), y);
+                }
+            }
+        }
+    }
+};
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_BIT_GRID_HPP
@@ -0,0 +1,166 @@
+#include "board.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace gol {
+
+board::board(int const w, int const h)
+    : m_width{ w }
+    , m_height{ h }
+    , m_cells(static_cast<std::size_t>(w + 2) * static_cast<std::size_t>(h + 2))
+{
+    static_assert(s_dead == 0, "Fresh boards rely on zeroed memory being dead");
+}
+
+board::board(int const w, int const h, gol::threadpool& pool)
+    : m_width{ w }
+    , m_height{ h }
+    , m_cells(static_cast<std::size_t>(w + 2) * static_cast<std::size_t>(h + 2))
+{
+    std::fill(this->row(-1) - 1, this->row(-1) - 1 + this->stride(), s_dead);
+    std::fill(this->row(h) - 1, this->row(h) - 1 + this->stride(), s_dead);
+
+    pool.parallel_for(
+        0,
+        static_cast<std::size_t>(h),
+        1,
+        [this](std::size_t const begin, std::size_t const end) {
+            auto* first = this->row(static_cast<int>(begin)) - 1;
+            std::fill(first, first + (end - begin) * this->stride(), s_dead);
+        },
+        schedule::static_chunks);
+}
+
+auto board::index(int const x, int const y) const noexcept -> std::size_t
+{
+    return static_cast<std::size_t>(y + 1) * this->stride() + static_cast<std::size_t>(x + 1);
+}
+
+auto board::width() const noexcept -> int
+{
+    return m_width;
+}
+
+auto board::height() const noexcept -> int
+{
+    return m_height;
+}
+
+auto board::stride() const noexcept -> std::size_t
+{
+    return static_cast<std::size_t>(m_width + 2);
+}
+
+auto board::at(int const x, int const y) noexcept -> unsigned char&
+{
+    return m_cells[this->index(x, y)];
+}
+
+auto board::at(int const x, int const y) const noexcept -> unsigned char
+{
+    return m_cells[this->index(x, y)];
+}
+
+auto board::row(int const y) noexcept -> unsigned char*
+{
+    return &m_cells[this->index(0, y)];
+}
+
+auto board::row(int const y) const noexcept -> unsigned char const*
+{
+    return &m_cells[this->index(0, y)];
+}
+
+auto board::clear() noexcept -> void
+{
+    std::fill(m_cells.begin(), m_cells.end(), s_dead);
+}
+
+auto board::fill_border(topology const t) noexcept -> void
+{
+    if(t == topology::bounded) {
+        std::fill(this->row(-1) - 1, this->row(-1) + m_width + 1, s_dead);
+        std::fill(this->row(m_height) - 1, this->row(m_height) + m_width + 1, s_dead);
+
+        for(int y = 0; y < m_height; ++y) {
+            this->at(-1, y) = s_dead;
+            this->at(m_width, y) = s_dead;
+        }
+
+        return;
+    }
+
+    std::copy(this->row(m_height - 1), this->row(m_height - 1) + m_width, this->row(-1));
+    std::copy(this->row(0), this->row(0) + m_width, this->row(m_height));
+
+    // the rows above already hold the wrapped corners
+    for(int y = -1; y <= m_height; ++y) {
+        this->at(-1, y) = this->at(m_width - 1, y);
+        this->at(m_width, y) = this->at(0, y);
+    }
+}
+
+auto board::population() const noexcept -> std::size_t
+{
+    std::size_t count = 0;
+
+    for(int y = 0; y < m_height; ++y) {
+        auto const* r = this->row(y);
+        count += static_cast<std::size_t>(std::accumulate(r, r + m_width, 0));
+    }
+
+    return count;
+}
+
+auto board::memory_usage() const noexcept -> std::size_t
+{
+    return m_cells.size();
+}
+
+auto board::memory_usage(int const w, int const h) noexcept -> std::size_t
+{
+    return static_cast<std::size_t>(w + 2) * static_cast<std::size_t>(h + 2);
+}
+
+// FNV-1a over the cells inside the border
+auto board::hash() const noexcept -> std::uint64_t
+{
+    constexpr std::uint64_t offset_basis = 14695981039346656037ULL;
+    constexpr std::uint64_t prime = 1099511628211ULL;
+
+    std::uint64_t h = offset_basis;
+
+    for(int y = 0; y < m_height; ++y) {
+        auto const* r = this->row(y);
+
+        for(int x = 0; x < m_width; ++x) {
+            h ^= r[x]; // NOLINT
+            h *= prime;
+        }
+    }
+
+    return h;
+}
+
+auto operator==(board const& a, board const& b) noexcept -> bool
+{
+    if(a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+
+    for(int y = 0; y < a.height(); ++y) {
+        if(!std::equal(a.row(y), a.row(y) + a.width(), b.row(y))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto operator!=(board const& a, board const& b) noexcept -> bool
+{
+    return !(a == b);
+}
+
+} // namespace gol
@@ -0,0 +1,75 @@
+#ifndef GOL_ENGINE_BOARD_HPP
+#define GOL_ENGINE_BOARD_HPP
+#pragma once
+
+#include "rule.hpp"
+#include "zeroed_allocator.hpp"
+
+#include "thread/thread_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gol {
+
+// Byte per cell grid surrounded by a one cell wide border, so neighbors of edge cells can be read without bounds
+// checks. The border is dead unless `fill_border` wraps it for a torus.
+class board
+{
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<unsigned char, zeroed_allocator<unsigned char>> m_cells;
+
+    [[nodiscard]] auto index(int x, int y) const noexcept -> std::size_t;
+
+public:
+    static constexpr unsigned char s_alive = 1;
+    static constexpr unsigned char s_dead = 0;
+
+    board() noexcept = default;
+    board(board const&) = default;
+    board(board&&) noexcept = default;
+    ~board() noexcept = default;
+
+    // all dead, the cells are zero pages until something is written to them
+    board(int w, int h);
+    // Every row is zeroed by the worker that gets it from pool.parallel_for(0, h, 1, ..., schedule::static_chunks),
+    // with first touch placement that's the NUMA node of the worker stepping those rows
+    board(int w, int h, gol::threadpool& pool);
+
+    auto operator=(board const&) -> board& = default;
+    auto operator=(board&&) noexcept -> board& = default;
+
+    [[nodiscard]] auto width() const noexcept -> int;
+    [[nodiscard]] auto height() const noexcept -> int;
+    // distance in bytes between two rows
+    [[nodiscard]] auto stride() const noexcept -> std::size_t;
+
+    // x in [-1, width], y in [-1, height]
+    [[nodiscard]] auto at(int x, int y) noexcept -> unsigned char&;
+    [[nodiscard]] auto at(int x, int y) const noexcept -> unsigned char;
+
+    // points at cell (0, y), valid from x = -1 to x = width
+    [[nodiscard]] auto row(int y) noexcept -> unsigned char*;
+    [[nodiscard]] auto row(int y) const noexcept -> unsigned char const*;
+
+    auto clear() noexcept -> void;
+    // dead border for a bounded board, copies of the opposite edges for a torus
+    auto fill_border(topology t) noexcept -> void;
+
+    [[nodiscard]] auto population() const noexcept -> std::size_t;
+    [[nodiscard]] auto hash() const noexcept -> std::uint64_t;
+
+    // bytes of cells, border included
+    [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+    [[nodiscard]] static auto memory_usage(int w, int h) noexcept -> std::size_t;
+};
+
+[[nodiscard]] auto operator==(board const& a, board const& b) noexcept -> bool;
+[[nodiscard]] auto operator!=(board const& a, board const& b) noexcept -> bool;
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_BOARD_HPP
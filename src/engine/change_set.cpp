@@ -0,0 +1,205 @@
+#include "change_set.hpp"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace gol {
+
+change_set::change_set(int const w, int const h)
+    : m_width{ w }
+    , m_height{ h }
+    , m_words_per_row{ static_cast<std::size_t>((w + s_word_bits - 1) / s_word_bits) }
+    , m_dirty_rows(static_cast<std::size_t>((h + s_word_bits - 1) / s_word_bits))
+    , m_mask(m_words_per_row * static_cast<std::size_t>(h))
+{
+}
+
+auto change_set::count_trailing_zeros(std::uint64_t const bits) noexcept -> int
+{
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+auto change_set::count_leading_zeros(std::uint64_t const bits) noexcept -> int
+{
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanReverse64(&index, bits);
+    return s_word_bits - 1 - static_cast<int>(index);
+#else
+    return __builtin_clzll(bits);
+#endif
+}
+
+auto change_set::mask_row(int const y) noexcept -> std::uint64_t*
+{
+    return &m_mask[static_cast<std::size_t>(y) * m_words_per_row];
+}
+
+auto change_set::mask_row(int const y) const noexcept -> std::uint64_t const*
+{
+    return &m_mask[static_cast<std::size_t>(y) * m_words_per_row];
+}
+
+auto change_set::mark_dirty(int const y) noexcept -> void
+{
+    m_dirty_rows[static_cast<std::size_t>(y / s_word_bits)] |= std::uint64_t{ 1 } << static_cast<unsigned>(y % s_word_bits);
+}
+
+auto change_set::width() const noexcept -> int
+{
+    return m_width;
+}
+
+auto change_set::height() const noexcept -> int
+{
+    return m_height;
+}
+
+auto change_set::empty() const noexcept -> bool
+{
+    return std::all_of(m_dirty_rows.begin(), m_dirty_rows.end(), [](std::uint64_t const bits) { return bits == 0; });
+}
+
+auto change_set::row_dirty(int const y) const noexcept -> bool
+{
+    return ((m_dirty_rows[static_cast<std::size_t>(y / s_word_bits)] >> static_cast<unsigned>(y % s_word_bits)) & 1U) !=
+           0;
+}
+
+auto change_set::row_bounds(int const y) const noexcept -> std::pair<int, int>
+{
+    auto const* row = this->mask_row(y);
+    auto const* const end = row + m_words_per_row; // NOLINT
+    auto const* first = std::find_if(row, end, [](std::uint64_t const bits) { return bits != 0; });
+
+    if(first == end) {
+        return { 0, 0 };
+    }
+
+    auto const* last = end - 1; // NOLINT
+    while(*last == 0) {
+        --last; // NOLINT
+    }
+
+    int const begin = static_cast<int>(first - row) * s_word_bits + count_trailing_zeros(*first);
+    int const past_end = static_cast<int>(last - row + 1) * s_word_bits - count_leading_zeros(*last);
+
+    return { begin, past_end };
+}
+
+auto change_set::payload_size() const noexcept -> std::size_t
+{
+    std::size_t num_dirty = 0;
+    this->for_each_dirty_row([&num_dirty](int) { ++num_dirty; });
+
+    return (m_dirty_rows.size() + num_dirty * m_words_per_row) * sizeof(std::uint64_t);
+}
+
+auto change_set::memory_usage() const noexcept -> std::size_t
+{
+    return (m_mask.size() + m_dirty_rows.size()) * sizeof(std::uint64_t);
+}
+
+auto change_set::memory_usage(int const w, int const h) noexcept -> std::size_t
+{
+    auto const words_per_row = static_cast<std::size_t>((w + s_word_bits - 1) / s_word_bits);
+    auto const row_words = static_cast<std::size_t>((h + s_word_bits - 1) / s_word_bits);
+
+    return (words_per_row * static_cast<std::size_t>(h) + row_words) * sizeof(std::uint64_t);
+}
+
+auto change_set::clear() noexcept -> void
+{
+    this->for_each_dirty_row([this](int const y) {
+        auto* row = this->mask_row(y);
+        std::fill(row, row + m_words_per_row, 0); // NOLINT
+    });
+
+    std::fill(m_dirty_rows.begin(), m_dirty_rows.end(), 0);
+}
+
+auto change_set::clear_row(int const y) noexcept -> void
+{
+    auto* row = this->mask_row(y);
+    std::fill(row, row + m_words_per_row, 0); // NOLINT
+    m_dirty_rows[static_cast<std::size_t>(y / s_word_bits)] &=
+        ~(std::uint64_t{ 1 } << static_cast<unsigned>(y % s_word_bits));
+}
+
+auto change_set::flip(int const x, int const y) noexcept -> void
+{
+    this->mask_row(y)[x / s_word_bits] ^= std::uint64_t{ 1 } << static_cast<unsigned>(x % s_word_bits); // NOLINT
+    this->mark_dirty(y);
+}
+
+auto change_set::flip_bits(int const y, std::size_t const word, std::uint64_t const bits) noexcept -> void
+{
+    if(bits == 0) {
+        return;
+    }
+
+    this->mask_row(y)[word] ^= bits; // NOLINT
+    this->mark_dirty(y);
+}
+
+auto change_set::record(board const& before, board const& after) noexcept -> void
+{
+    for(int y = 0; y < m_height; ++y) {
+        this->record_row(y, before, after);
+    }
+}
+
+auto change_set::record_row(int const y, board const& before, board const& after) noexcept -> void
+{
+    auto const* a = before.row(y);
+    auto const* b = after.row(y);
+    auto* row = this->mask_row(y);
+    std::uint64_t any = 0;
+
+    for(std::size_t i = 0; i < m_words_per_row; ++i) {
+        int const begin = static_cast<int>(i) * s_word_bits;
+        int const end = std::min(begin + s_word_bits, m_width);
+        std::uint64_t word = 0;
+
+        for(int x = begin; x < end; ++x) {
+            word |= static_cast<std::uint64_t>(a[x] ^ b[x]) << static_cast<unsigned>(x - begin); // NOLINT
+        }
+
+        row[i] ^= word; // NOLINT
+        any |= word;
+    }
+
+    if(any != 0) {
+        this->mark_dirty(y);
+    }
+}
+
+auto change_set::merge(change_set const& other) noexcept -> void
+{
+    other.for_each_dirty_row([this, &other](int const y) {
+        auto const* theirs = other.mask_row(y);
+        auto* ours = this->mask_row(y);
+
+        for(std::size_t i = 0; i < m_words_per_row; ++i) {
+            ours[i] ^= theirs[i]; // NOLINT
+        }
+
+        this->mark_dirty(y);
+    });
+}
+
+auto change_set::apply(board& b) const noexcept -> void
+{
+    this->for_each_flip([&b](int const x, int const y) { b.at(x, y) ^= board::s_alive; });
+}
+
+} // namespace gol
@@ -0,0 +1,100 @@
+#ifndef GOL_ENGINE_CHANGE_SET_HPP
+#define GOL_ENGINE_CHANGE_SET_HPP
+#pragma once
+
+#include "board.hpp"
+#include "zeroed_allocator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gol {
+
+// The cells that flipped between two boards as a bit-packed XOR mask, plus a bitmap of the rows that may have flips in
+// them so readers and clear() only touch rows that changed. Applying two change sets one after the other is the same as
+// applying their merge.
+class change_set
+{
+private:
+    static constexpr int s_word_bits = 64;
+
+    int m_width = 0;
+    int m_height = 0;
+    std::size_t m_words_per_row = 0;
+    std::vector<std::uint64_t, zeroed_allocator<std::uint64_t>> m_dirty_rows;
+    std::vector<std::uint64_t, zeroed_allocator<std::uint64_t>> m_mask;
+
+    [[nodiscard]] auto mask_row(int y) noexcept -> std::uint64_t*;
+    auto mark_dirty(int y) noexcept -> void;
+
+public:
+    change_set() noexcept = default;
+    change_set(change_set const&) = default;
+    change_set(change_set&&) noexcept = default;
+    ~change_set() noexcept = default;
+
+    change_set(int w, int h);
+
+    auto operator=(change_set const&) -> change_set& = default;
+    auto operator=(change_set&&) noexcept -> change_set& = default;
+
+    [[nodiscard]] auto width() const noexcept -> int;
+    [[nodiscard]] auto height() const noexcept -> int;
+    [[nodiscard]] auto empty() const noexcept -> bool;
+    [[nodiscard]] auto row_dirty(int y) const noexcept -> bool;
+    [[nodiscard]] auto mask_row(int y) const noexcept -> std::uint64_t const*;
+    // first and one past the last flipped cell of row y, an empty range if nothing flipped
+    [[nodiscard]] auto row_bounds(int y) const noexcept -> std::pair<int, int>;
+    // bytes a reader has to look at: the row bitmap and the mask of every dirty row
+    [[nodiscard]] auto payload_size() const noexcept -> std::size_t;
+    // bytes of the mask and the row bitmap
+    [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+    [[nodiscard]] static auto memory_usage(int w, int h) noexcept -> std::size_t;
+
+    auto clear() noexcept -> void;
+    auto clear_row(int y) noexcept -> void;
+    auto flip(int x, int y) noexcept -> void;
+    // flips cells 64 * word + i of row y for every bit i set in `bits`
+    auto flip_bits(int y, std::size_t word, std::uint64_t bits) noexcept -> void;
+    // adds the cells that differ between `before` and `after`, both the same size as the change set
+    auto record(board const& before, board const& after) noexcept -> void;
+    auto record_row(int y, board const& before, board const& after) noexcept -> void;
+    auto merge(change_set const& other) noexcept -> void;
+    auto apply(board& b) const noexcept -> void;
+
+    // calls fn(y) for every dirty row, top to bottom
+    template<typename Function>
+    auto for_each_dirty_row(Function&& fn) const -> void
+    {
+        for(std::size_t i = 0; i < m_dirty_rows.size(); ++i) {
+            for(auto bits = m_dirty_rows[i]; bits != 0; bits &= bits - 1) {
+                fn(static_cast<int>(i) * s_word_bits + count_trailing_zeros(bits));
+            }
+        }
+    }
+
+    // calls fn(x, y) for every flipped cell, row by row
+    template<typename Function>
+    auto for_each_flip(Function&& fn) const -> void
+    {
+        this->for_each_dirty_row([this, &fn](int const y) {
+            auto const* row = this->mask_row(y);
+
+            for(std::size_t i = 0; i < m_words_per_row; ++i) {
+                for(auto bits = row[i]; bits != 0; bits &= bits - 1) { // NOLINT
+                    fn(static_cast<int>(i) * s_word_bits + count_trailing_zeros(bits), y);
+                }
+            }
+        });
+    }
+
+    // bits != 0
+    [[nodiscard]] static auto count_trailing_zeros(std::uint64_t bits) noexcept -> int;
+    [[nodiscard]] static auto count_leading_zeros(std::uint64_t bits) noexcept -> int;
+};
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_CHANGE_SET_HPP
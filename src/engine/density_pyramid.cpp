@@ -0,0 +1,140 @@
+#include "density_pyramid.hpp"
+
+#include <algorithm>
+
+namespace gol {
+
+density_pyramid::density_pyramid(int const w, int const h)
+{
+    // memory_usage(w, h) walks the levels the same way
+    for(int k = 1; k <= s_max_level; ++k) {
+        int const scale = 1 << k;
+        level l;
+
+        l.width = (w + scale - 1) / scale;
+        l.height = (h + scale - 1) / scale;
+        l.tiles_x = (l.width + s_tile_size - 1) / s_tile_size;
+        l.counts = decltype(l.counts)(static_cast<std::size_t>(l.width) * static_cast<std::size_t>(l.height));
+        l.dirty_tiles.resize(static_cast<std::size_t>(l.tiles_x) *
+                                 static_cast<std::size_t>((l.height + s_tile_size - 1) / s_tile_size),
+                             0);
+
+        m_levels.push_back(std::move(l));
+
+        if(m_levels.back().width == 1 && m_levels.back().height == 1) {
+            break;
+        }
+    }
+}
+
+auto density_pyramid::memory_usage() const noexcept -> std::size_t
+{
+    std::size_t bytes = 0;
+
+    for(auto const& l : m_levels) {
+        bytes += l.counts.size() * sizeof(std::uint16_t) + l.dirty_tiles.size();
+    }
+
+    return bytes;
+}
+
+auto density_pyramid::memory_usage(int const w, int const h) noexcept -> std::size_t
+{
+    std::size_t bytes = 0;
+
+    for(int k = 1; k <= s_max_level; ++k) {
+        int const scale = 1 << k;
+        int const width = (w + scale - 1) / scale;
+        int const height = (h + scale - 1) / scale;
+        auto const tiles = static_cast<std::size_t>((width + s_tile_size - 1) / s_tile_size) *
+                           static_cast<std::size_t>((height + s_tile_size - 1) / s_tile_size);
+
+        bytes += static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * sizeof(std::uint16_t) + tiles;
+
+        if(width == 1 && height == 1) {
+            break;
+        }
+    }
+
+    return bytes;
+}
+
+auto density_pyramid::at(int const k) noexcept -> level&
+{
+    return m_levels[static_cast<std::size_t>(k - 1)];
+}
+
+auto density_pyramid::at(int const k) const noexcept -> level const&
+{
+    return m_levels[static_cast<std::size_t>(k - 1)];
+}
+
+auto density_pyramid::levels() const noexcept -> int
+{
+    return static_cast<int>(m_levels.size());
+}
+
+auto density_pyramid::width(int const k) const noexcept -> int
+{
+    return this->at(k).width;
+}
+
+auto density_pyramid::height(int const k) const noexcept -> int
+{
+    return this->at(k).height;
+}
+
+auto density_pyramid::count(int const k, int const x, int const y) const noexcept -> int
+{
+    auto const& l = this->at(k);
+    return l.counts[static_cast<std::size_t>(y) * static_cast<std::size_t>(l.width) + static_cast<std::size_t>(x)];
+}
+
+auto density_pyramid::density(int const k, int const x, int const y) const noexcept -> unsigned char
+{
+    constexpr int max_density = 255;
+    int const area = 1 << (2 * k);
+
+    return static_cast<unsigned char>((this->count(k, x, y) * max_density + area / 2) / area);
+}
+
+auto density_pyramid::population() const noexcept -> std::size_t
+{
+    return m_population;
+}
+
+auto density_pyramid::add(int const x, int const y, int const delta) noexcept -> void
+{
+    // wraps around to a subtraction for negative deltas
+    m_population += static_cast<std::size_t>(delta);
+
+    for(int k = 1; k <= this->levels(); ++k) {
+        auto& l = this->at(k);
+        int const lx = x >> k;
+        int const ly = y >> k;
+        auto& c = l.counts[static_cast<std::size_t>(ly) * static_cast<std::size_t>(l.width) + static_cast<std::size_t>(lx)];
+
+        c = static_cast<std::uint16_t>(c + delta);
+        l.dirty_tiles[static_cast<std::size_t>(ly / s_tile_size) * static_cast<std::size_t>(l.tiles_x) +
+                      static_cast<std::size_t>(lx / s_tile_size)] = 1;
+    }
+}
+
+auto density_pyramid::apply(change_set const& changes, board const& after) noexcept -> void
+{
+    changes.for_each_flip(
+        [this, &after](int const x, int const y) { this->add(x, y, after.at(x, y) == board::s_alive ? 1 : -1); });
+}
+
+auto density_pyramid::apply(change_set const& changes, bit_grid const& after) noexcept -> void
+{
+    changes.for_each_flip([this, &after](int const x, int const y) { this->add(x, y, after.test(x, y) ? 1 : -1); });
+}
+
+auto density_pyramid::mark_dirty(int const k) noexcept -> void
+{
+    auto& l = this->at(k);
+    std::fill(l.dirty_tiles.begin(), l.dirty_tiles.end(), 1);
+}
+
+} // namespace gol
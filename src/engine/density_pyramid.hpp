@@ -0,0 +1,119 @@
+#ifndef GOL_ENGINE_DENSITY_PYRAMID_HPP
+#define GOL_ENGINE_DENSITY_PYRAMID_HPP
+#pragma once
+
+#include "bit_grid.hpp"
+#include "board.hpp"
+#include "change_set.hpp"
+#include "zeroed_allocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gol {
+
+// Population counts of 2x2, 4x4, ... blocks of a board, kept up to date one flip at a time. Level k has a texel per
+// 2^k x 2^k block of cells, level 0 would be the board itself and isn't stored. Texels whose counts changed are
+// tracked in tiles so a reader can copy out only what it needs.
+class density_pyramid
+{
+private:
+    struct level
+    {
+        int width = 0;
+        int height = 0;
+        int tiles_x = 0;
+        std::vector<std::uint16_t, zeroed_allocator<std::uint16_t>> counts;
+        std::vector<unsigned char> dirty_tiles;
+    };
+
+    std::vector<level> m_levels;
+    // alive cells, kept by add() so it's right even without any levels
+    std::size_t m_population = 0;
+
+    [[nodiscard]] auto at(int k) noexcept -> level&;
+    [[nodiscard]] auto at(int k) const noexcept -> level const&;
+
+public:
+    // 4^7 cells still fit in the counts
+    static constexpr int s_max_level = 7;
+    static constexpr int s_tile_size = 64;
+
+    density_pyramid() noexcept = default;
+    density_pyramid(density_pyramid const&) = default;
+    density_pyramid(density_pyramid&&) noexcept = default;
+    ~density_pyramid() noexcept = default;
+
+    // every cell dead, levels stop once one texel covers the board or at s_max_level
+    density_pyramid(int w, int h);
+
+    auto operator=(density_pyramid const&) -> density_pyramid& = default;
+    auto operator=(density_pyramid&&) noexcept -> density_pyramid& = default;
+
+    // the coarsest level, 0 if there are none
+    [[nodiscard]] auto levels() const noexcept -> int;
+    [[nodiscard]] auto width(int k) const noexcept -> int;
+    [[nodiscard]] auto height(int k) const noexcept -> int;
+    [[nodiscard]] auto count(int k, int x, int y) const noexcept -> int;
+    // fraction of alive cells in a block as 0 to 255
+    [[nodiscard]] auto density(int k, int x, int y) const noexcept -> unsigned char;
+    // alive cells on the whole board, every cell counted by add() or apply() whether or not there are levels
+    [[nodiscard]] auto population() const noexcept -> std::size_t;
+
+    // bytes of the counts and dirty tiles of every level
+    [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+    [[nodiscard]] static auto memory_usage(int w, int h) noexcept -> std::size_t;
+
+    // cell (x, y) became alive for +1 or dead for -1
+    auto add(int x, int y, int delta) noexcept -> void;
+    // every flip in `changes`, `after` is the board with them applied
+    auto apply(change_set const& changes, board const& after) noexcept -> void;
+    auto apply(change_set const& changes, bit_grid const& after) noexcept -> void;
+    auto mark_dirty(int k) noexcept -> void;
+
+    // Calls fn(x, y, w, h) with rectangles of level k texels covering every dirty tile that overlaps texels
+    // [x0, x1) x [y0, y1), one per run of dirty tiles in a row of tiles, and marks those tiles clean
+    template<typename Function>
+    auto take_dirty(int const k, int const x0, int const y0, int const x1, int const y1, Function&& fn) -> void
+    {
+        auto& l = this->at(k);
+
+        if(x0 >= x1 || y0 >= y1) {
+            return;
+        }
+
+        int const first_tx = x0 / s_tile_size;
+        int const last_tx = (x1 - 1) / s_tile_size;
+
+        for(int ty = y0 / s_tile_size; ty <= (y1 - 1) / s_tile_size; ++ty) {
+            int const y = ty * s_tile_size;
+            int const h = std::min(s_tile_size, l.height - y);
+
+            for(int tx = first_tx; tx <= last_tx;) {
+                auto const tile = [&l, ty](int const t) -> unsigned char& {
+                    return l.dirty_tiles[static_cast<std::size_t>(ty) * static_cast<std::size_t>(l.tiles_x) +
+                                         static_cast<std::size_t>(t)];
+                };
+
+                if(tile(tx) == 0) {
+                    ++tx;
+                    continue;
+                }
+
+                int const begin = tx;
+                for(; tx <= last_tx && tile(tx) != 0; ++tx) {
+                    tile(tx) = 0;
+                }
+
+                int const x = begin * s_tile_size;
+                fn(x, y, std::min(tx * s_tile_size, l.width) - x, h);
+            }
+        }
+    }
+};
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_DENSITY_PYRAMID_HPP
@@ -0,0 +1,196 @@
+#include "engine.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace {
+
+// next state of a cell indexed by alive * 9 + number of alive neighbors
+using rule_table = std::array<unsigned char, 18>;
+
+[[nodiscard]] auto make_table(gol::rule const& r) noexcept -> rule_table
+{
+    rule_table table{};
+
+    for(unsigned count = 0; count <= 8; ++count) {
+        table.at(count) = static_cast<unsigned char>((r.birth >> count) & 1U);
+        table.at(9 + count) = static_cast<unsigned char>((r.survive >> count) & 1U);
+    }
+
+    return table;
+}
+
+// rows [y_begin, y_end) of `next`, `column_sums` must hold at least width + 2 values
+auto step_rows(gol::board const& current,
+               gol::board& next,
+               rule_table const& table,
+               unsigned char* column_sums,
+               int const y_begin,
+               int const y_end) noexcept -> void
+{
+    int const width = current.width();
+
+    for(int y = y_begin; y < y_end; ++y) {
+        auto const* above = current.row(y - 1) - 1;
+        auto const* middle = current.row(y) - 1;
+        auto const* below = current.row(y + 1) - 1;
+        auto* out = next.row(y);
+
+        for(int x = 0; x < width + 2; ++x) {
+            column_sums[x] = static_cast<unsigned char>(above[x] + middle[x] + below[x]); // NOLINT
+        }
+
+        for(int x = 0; x < width; ++x) {
+            auto const alive = middle[x + 1];                                                   // NOLINT
+            int const count = column_sums[x] + column_sums[x + 1] + column_sums[x + 2] - alive; // NOLINT
+            out[x] = table[static_cast<std::size_t>(alive * 9 + count)];                       // NOLINT
+        }
+    }
+}
+
+} // namespace
+
+namespace gol {
+
+auto engine::set_rule(gol::rule const& r) noexcept -> void
+{
+    m_rule = r;
+}
+
+auto engine::set_topology(gol::topology const t) noexcept -> void
+{
+    m_topology = t;
+}
+
+auto engine::rule() const noexcept -> gol::rule const&
+{
+    return m_rule;
+}
+
+auto engine::topology() const noexcept -> gol::topology
+{
+    return m_topology;
+}
+
+auto engine::make_board(int const w, int const h) -> board
+{
+    return board{ w, h };
+}
+
+auto engine::step(board& current, board& next) -> void
+{
+    current.fill_border(m_topology);
+    this->step_impl(current, next);
+}
+
+auto scalar_engine::name() const -> std::string
+{
+    return "scalar";
+}
+
+auto scalar_engine::multithreaded() const noexcept -> bool
+{
+    return false;
+}
+
+auto scalar_engine::step_impl(board const& current, board& next) -> void
+{
+    auto const& r = this->rule();
+
+    for(int i = 0; i < current.height(); ++i) {
+        for(int j = 0; j < current.width(); ++j) {
+            std::array<unsigned char, 8> const neighbors = { current.at(j - 1, i - 1), current.at(j, i - 1),
+                                                             current.at(j + 1, i - 1), current.at(j - 1, i),
+                                                             current.at(j + 1, i),     current.at(j - 1, i + 1),
+                                                             current.at(j, i + 1),     current.at(j + 1, i + 1) };
+            int count = 0;
+
+            for(auto const neighbor : neighbors) {
+                count += neighbor;
+            }
+
+            auto const mask = current.at(j, i) == board::s_alive ? r.survive : r.birth;
+            next.at(j, i) = static_cast<unsigned char>((mask >> count) & 1);
+        }
+    }
+}
+
+auto sliding_engine::name() const -> std::string
+{
+    return "sliding";
+}
+
+auto sliding_engine::multithreaded() const noexcept -> bool
+{
+    return false;
+}
+
+auto sliding_engine::step_impl(board const& current, board& next) -> void
+{
+    m_column_sums.resize(static_cast<std::size_t>(current.width() + 2));
+    step_rows(current, next, make_table(this->rule()), m_column_sums.data(), 0, current.height());
+}
+
+parallel_engine::parallel_engine(std::size_t const num_threads, bool const pin_threads)
+    : m_threadpool{ std::max<std::size_t>(num_threads, 1), pin_threads }
+    , m_column_sums(m_threadpool.size())
+{
+}
+
+auto parallel_engine::name() const -> std::string
+{
+    return "parallel";
+}
+
+auto parallel_engine::multithreaded() const noexcept -> bool
+{
+    return true;
+}
+
+auto parallel_engine::make_board(int const w, int const h) -> board
+{
+    return board{ w, h, m_threadpool };
+}
+
+auto parallel_engine::step_impl(board const& current, board& next) -> void
+{
+    auto const table = make_table(this->rule());
+
+    for(auto& sums : m_column_sums) {
+        sums.resize(static_cast<std::size_t>(current.width() + 2));
+    }
+
+    // the same bands as make_board(), so with pinned workers every band stays on its worker's NUMA node
+    m_threadpool.parallel_for(
+        0,
+        static_cast<std::size_t>(current.height()),
+        1,
+        [this, &current, &next, &table](std::size_t const begin, std::size_t const end) {
+            auto& column_sums = m_column_sums[gol::threadpool::current_worker()];
+            step_rows(current, next, table, column_sums.data(), static_cast<int>(begin), static_cast<int>(end));
+        },
+        schedule::static_chunks);
+}
+
+auto available_engines() -> std::vector<std::string>
+{
+    return { "scalar", "sliding", "parallel" };
+}
+
+auto make_engine(std::string const& name, std::size_t const num_threads, bool const pin_threads)
+    -> std::unique_ptr<engine>
+{
+    if(name == "scalar") {
+        return std::make_unique<scalar_engine>();
+    }
+    if(name == "sliding") {
+        return std::make_unique<sliding_engine>();
+    }
+    if(name == "parallel") {
+        return std::make_unique<parallel_engine>(num_threads, pin_threads);
+    }
+
+    return nullptr;
+}
+
+} // namespace gol
@@ -0,0 +1,103 @@
+#ifndef GOL_ENGINE_ENGINE_HPP
+#define GOL_ENGINE_ENGINE_HPP
+#pragma once
+
+#include "board.hpp"
+#include "rule.hpp"
+
+#include "thread/thread_pool.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gol {
+
+class engine
+{
+private:
+    gol::rule m_rule{};
+    gol::topology m_topology = gol::topology::bounded;
+
+protected:
+    // the border of `current` is already filled for the topology
+    virtual auto step_impl(board const& current, board& next) -> void = 0;
+
+public:
+    engine() noexcept = default;
+    engine(engine const&) = delete;
+    engine(engine&&) noexcept = delete;
+    virtual ~engine() noexcept = default;
+
+    auto operator=(engine const&) -> engine& = delete;
+    auto operator=(engine&&) noexcept -> engine& = delete;
+
+    [[nodiscard]] virtual auto name() const -> std::string = 0;
+    [[nodiscard]] virtual auto multithreaded() const noexcept -> bool = 0;
+    // a dead board laid out in memory the way this engine likes best
+    [[nodiscard]] virtual auto make_board(int w, int h) -> board;
+
+    auto set_rule(gol::rule const& r) noexcept -> void;
+    auto set_topology(gol::topology t) noexcept -> void;
+    [[nodiscard]] auto rule() const noexcept -> gol::rule const&;
+    [[nodiscard]] auto topology() const noexcept -> gol::topology;
+
+    // computes the generation after `current` into `next`, both must have the same size. Only the border of
+    // `current` is written to.
+    auto step(board& current, board& next) -> void;
+};
+
+// Counts the 8 neighbors of every cell one by one, the reference the other engines are checked against
+class scalar_engine : public engine
+{
+protected:
+    auto step_impl(board const& current, board& next) -> void override;
+
+public:
+    [[nodiscard]] auto name() const -> std::string override;
+    [[nodiscard]] auto multithreaded() const noexcept -> bool override;
+};
+
+// Sums every column of 3 cells once per row and slides a 3 wide window over the sums
+class sliding_engine : public engine
+{
+private:
+    std::vector<unsigned char> m_column_sums;
+
+protected:
+    auto step_impl(board const& current, board& next) -> void override;
+
+public:
+    [[nodiscard]] auto name() const -> std::string override;
+    [[nodiscard]] auto multithreaded() const noexcept -> bool override;
+};
+
+// The sliding window kernel run over bands of rows on a thread pool, each worker always gets the same band
+class parallel_engine : public engine
+{
+private:
+    gol::threadpool m_threadpool;
+    // one per worker
+    std::vector<std::vector<unsigned char>> m_column_sums;
+
+protected:
+    auto step_impl(board const& current, board& next) -> void override;
+
+public:
+    explicit parallel_engine(std::size_t num_threads, bool pin_threads = false);
+
+    [[nodiscard]] auto name() const -> std::string override;
+    [[nodiscard]] auto multithreaded() const noexcept -> bool override;
+    // rows are first touched by the workers that step them
+    [[nodiscard]] auto make_board(int w, int h) -> board override;
+};
+
+[[nodiscard]] auto available_engines() -> std::vector<std::string>;
+// nullptr for an unknown name, `num_threads` and `pin_threads` are ignored by the single threaded engines
+[[nodiscard]] auto make_engine(std::string const& name, std::size_t num_threads, bool pin_threads = false)
+    -> std::unique_ptr<engine>;
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_ENGINE_HPP
@@ -0,0 +1,244 @@
+#include "pattern.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+
+namespace {
+
+[[nodiscard]] auto is_rle_header(std::string_view const line) -> bool
+{
+    auto const first = line.find_first_not_of(" \t");
+    return first != std::string_view::npos && line[first] == 'x' && line.find('=') != std::string_view::npos;
+}
+
+// the line starting at `at` without its line ending, `at` moves to the next one
+[[nodiscard]] auto next_line(std::string_view const text, std::size_t& at) -> std::string_view
+{
+    auto const end = std::min(text.find('\n', at), text.size());
+    auto line = text.substr(at, end - at);
+    at = std::min(end + 1, text.size());
+
+    if(!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    return line;
+}
+
+// value * 10 + the digit `c`, false instead if that doesn't fit in an int
+[[nodiscard]] auto append_digit(int& value, char const c) noexcept -> bool
+{
+    auto const digit = c - '0';
+
+    if(value > (std::numeric_limits<int>::max() - digit) / 10) {
+        return false;
+    }
+
+    value = value * 10 + digit;
+    return true;
+}
+
+// the value after `key =` in an RLE header, 0 if it isn't there or negative, nullopt if it doesn't fit in an int
+[[nodiscard]] auto header_value(std::string_view const header, char const key) -> std::optional<int>
+{
+    for(std::size_t i = 0; i < header.size(); ++i) {
+        if(header[i] != key) {
+            continue;
+        }
+
+        auto const eq = header.find_first_not_of(" \t", i + 1);
+
+        if(eq == std::string_view::npos || header[eq] != '=') {
+            continue;
+        }
+
+        auto at = header.find_first_not_of(" \t", eq + 1);
+        auto const negative = at != std::string_view::npos && header[at] == '-';
+        int value = 0;
+
+        if(negative) {
+            ++at;
+        }
+
+        for(; at < header.size() && std::isdigit(static_cast<unsigned char>(header[at])) != 0; ++at) {
+            if(!append_digit(value, header[at])) {
+                return std::nullopt;
+            }
+        }
+
+        return negative ? 0 : value;
+    }
+
+    return 0;
+}
+
+// calls run(x, y, n) for the alive cells (x, y) to (x + n - 1, y) of every line of `text`, false if the text is
+// malformed or `run` returns false
+template<typename Run>
+auto read_plaintext(std::string_view const text, Run&& run) -> bool
+{
+    std::size_t at = 0;
+    int y = 0;
+
+    while(at < text.size()) {
+        auto const line = next_line(text, at);
+
+        if(!line.empty() && line.front() == '!') {
+            continue;
+        }
+
+        for(std::size_t x = 0; x < line.size(); ++x) {
+            if(line[x] == 'O' || line[x] == '*') {
+                if(!run(static_cast<int>(x), y, 1)) {
+                    return false;
+                }
+            }
+            else if(line[x] != '.' && std::isspace(static_cast<unsigned char>(line[x])) == 0) {
+                return false;
+            }
+        }
+
+        ++y;
+    }
+
+    return true;
+}
+
+// like read_plaintext(), for the runs after an RLE header
+template<typename Run>
+auto read_rle(std::string_view const text, Run&& run) -> bool
+{
+    int x = 0;
+    int y = 0;
+    int digits = 0;
+
+    for(char const c : text) {
+        if(std::isdigit(static_cast<unsigned char>(c)) != 0) {
+            if(!append_digit(digits, c)) {
+                return false;
+            }
+            continue;
+        }
+        if(std::isspace(static_cast<unsigned char>(c)) != 0) {
+            continue;
+        }
+
+        int const count = std::max(digits, 1);
+        digits = 0;
+
+        if(c == '!') {
+            return true;
+        }
+
+        // positions stay below INT_MAX so the grid's size fits in an int, going further is as bad as a bad character
+        auto& position = c == '$' ? y : x;
+        if(count >= std::numeric_limits<int>::max() - position) {
+            return false;
+        }
+
+        if(c == '$') {
+            x = 0;
+            y += count;
+        }
+        else if(c == 'b' || c == '.') {
+            x += count;
+        }
+        else if(std::isalpha(static_cast<unsigned char>(c)) != 0) {
+            // every state but the dead one counts as alive
+            if(!run(x, y, count)) {
+                return false;
+            }
+            x += count;
+        }
+        else {
+            return false;
+        }
+    }
+
+    // a missing '!' is common enough to let it go
+    return true;
+}
+
+} // namespace
+
+namespace gol {
+
+auto read_pattern(std::string_view const text, int const max_width, int const max_height) -> std::optional<bit_grid>
+{
+    std::size_t at = 0;
+    std::string_view line;
+
+    // RLE comments come before the header, plaintext ones start with '!'
+    do {
+        line = next_line(text, at);
+    } while(!line.empty() && line.front() == '#' && at < text.size());
+
+    auto const rle = is_rle_header(line);
+    int width = 0;
+    int height = 0;
+
+    if(rle) {
+        auto const header_width = header_value(line, 'x');
+        auto const header_height = header_value(line, 'y');
+
+        if(!header_width.has_value() || !header_height.has_value()) {
+            return std::nullopt;
+        }
+
+        width = *header_width;
+        height = *header_height;
+    }
+
+    // plaintext starts with the line that wasn't a comment
+    auto const cells = rle ? text.substr(at) : text.substr(static_cast<std::size_t>(line.data() - text.data()));
+    auto const for_each_run = [rle, cells](auto&& run) {
+        return rle ? read_rle(cells, run) : read_plaintext(cells, run);
+    };
+
+    // the size first, so a pattern that's too big is turned down before anything is allocated for it
+    bool any = false;
+    auto const measured = for_each_run([&](int const x, int const y, int const n) {
+        any = true;
+        width = std::max(width, x + n);
+        height = std::max(height, y + 1);
+        return width <= max_width && height <= max_height;
+    });
+
+    if(!measured || !any || width > max_width || height > max_height) {
+        return std::nullopt;
+    }
+
+    bit_grid pattern{ width, height };
+
+    for_each_run([&pattern](int const x, int const y, int const n) {
+        for(int i = 0; i < n; ++i) {
+            pattern.set(x + i, y);
+        }
+        return true;
+    });
+
+    return pattern;
+}
+
+auto read_pattern(std::istream& in, int const max_width, int const max_height) -> std::optional<bit_grid>
+{
+    std::string const text{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+    return read_pattern(text, max_width, max_height);
+}
+
+auto load_pattern(std::string const& path) -> std::optional<bit_grid>
+{
+    std::ifstream in{ path };
+
+    if(!in) {
+        return std::nullopt;
+    }
+
+    return read_pattern(in);
+}
+
+} // namespace gol
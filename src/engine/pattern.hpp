@@ -0,0 +1,29 @@
+#ifndef GOL_ENGINE_PATTERN_HPP
+#define GOL_ENGINE_PATTERN_HPP
+#pragma once
+
+#include "bit_grid.hpp"
+
+#include <istream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace gol {
+
+// Plaintext (.cells) or run length encoded (.rle) pattern, told apart by the `x = ...` header of the latter. The grid
+// is as big as the pattern's bounding box, or the size in the RLE header if that's bigger. nullopt if the text is
+// malformed, has no cells or has a size or run past INT_MAX. A grid that would be wider than `max_width` or taller
+// than `max_height` is nullopt as well, found out before it's allocated.
+[[nodiscard]] auto read_pattern(std::string_view text,
+                                int max_width = std::numeric_limits<int>::max(),
+                                int max_height = std::numeric_limits<int>::max()) -> std::optional<bit_grid>;
+[[nodiscard]] auto read_pattern(std::istream& in,
+                                int max_width = std::numeric_limits<int>::max(),
+                                int max_height = std::numeric_limits<int>::max()) -> std::optional<bit_grid>;
+[[nodiscard]] auto load_pattern(std::string const& path) -> std::optional<bit_grid>;
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_PATTERN_HPP
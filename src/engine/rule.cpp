@@ -0,0 +1,83 @@
+#include "rule.hpp"
+
+#include <cctype>
+
+namespace gol {
+
+auto operator==(rule const& a, rule const& b) noexcept -> bool
+{
+    return a.birth == b.birth && a.survive == b.survive;
+}
+
+auto operator!=(rule const& a, rule const& b) noexcept -> bool
+{
+    return !(a == b);
+}
+
+auto parse_rule(std::string const& text) -> std::optional<rule>
+{
+    rule r{ 0, 0 };
+    std::uint16_t* current = nullptr;
+
+    for(char const c : text) {
+        auto const upper = std::toupper(static_cast<unsigned char>(c));
+
+        if(upper == 'B') {
+            current = &r.birth;
+        }
+        else if(upper == 'S') {
+            current = &r.survive;
+        }
+        else if(c == '/') {
+            current = nullptr;
+        }
+        else if(c >= '0' && c <= '8' && current != nullptr) {
+            *current = static_cast<std::uint16_t>(*current | (1U << static_cast<unsigned>(c - '0')));
+        }
+        else {
+            return std::nullopt;
+        }
+    }
+
+    return r;
+}
+
+auto to_string(rule const& r) -> std::string
+{
+    std::string text = "B";
+
+    for(unsigned i = 0; i <= 8; ++i) {
+        if(((r.birth >> i) & 1U) != 0) {
+            text += static_cast<char>('0' + i);
+        }
+    }
+
+    text += "/S";
+
+    for(unsigned i = 0; i <= 8; ++i) {
+        if(((r.survive >> i) & 1U) != 0) {
+            text += static_cast<char>('0' + i);
+        }
+    }
+
+    return text;
+}
+
+auto parse_topology(std::string const& text) -> std::optional<topology>
+{
+    if(text == "bounded") {
+        return topology::bounded;
+    }
+    if(text == "torus") {
+        return topology::torus;
+    }
+
+    return std::nullopt;
+}
+
+auto to_string(topology const t) -> std::string
+{
+    return t == topology::torus ? "torus" : "bounded";
+}
+
+} // namespace gol
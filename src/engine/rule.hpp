@@ -0,0 +1,36 @@
+#ifndef GOL_ENGINE_RULE_HPP
+#define GOL_ENGINE_RULE_HPP
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace gol {
+
+// Outer totalistic rule, bit n of `birth`/`survive` set <=> a cell with n alive neighbors is born/survives
+struct rule
+{
+    std::uint16_t birth = 1U << 3U;
+    std::uint16_t survive = (1U << 2U) | (1U << 3U);
+};
+
+[[nodiscard]] auto operator==(rule const& a, rule const& b) noexcept -> bool;
+[[nodiscard]] auto operator!=(rule const& a, rule const& b) noexcept -> bool;
+
+// "B3/S23" notation
+[[nodiscard]] auto parse_rule(std::string const& text) -> std::optional<rule>;
+[[nodiscard]] auto to_string(rule const& r) -> std::string;
+
+enum class topology
+{
+    bounded, // everything outside the board is dead
+    torus    // leaving an edge wraps around to the opposite one
+};
+
+[[nodiscard]] auto parse_topology(std::string const& text) -> std::optional<topology>;
+[[nodiscard]] auto to_string(topology t) -> std::string;
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_RULE_HPP
@@ -0,0 +1,189 @@
+#include "validate.hpp"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace {
+
+[[nodiscard]] auto diverges(gol::engine& candidate, gol::board const& input) -> bool
+{
+    gol::board current = input;
+    gol::board next{ input.width(), input.height() };
+
+    candidate.step(current, next);
+
+    return next != gol::reference_step(input, candidate.rule(), candidate.topology());
+}
+
+// The cells `candidate` gets wrong and their neighbors, if the engine still gets it wrong on that alone
+[[nodiscard]] auto crop(gol::engine& candidate, gol::board input) -> gol::board
+{
+    // a torus has no edge to crop at without changing what wraps around
+    if(candidate.topology() != gol::topology::bounded) {
+        return input;
+    }
+
+    gol::board current = input;
+    gol::board actual{ input.width(), input.height() };
+    candidate.step(current, actual);
+    auto const expected = gol::reference_step(input, candidate.rule(), candidate.topology());
+
+    int min_x = input.width();
+    int min_y = input.height();
+    int max_x = -1;
+    int max_y = -1;
+
+    for(int y = 0; y < input.height(); ++y) {
+        for(int x = 0; x < input.width(); ++x) {
+            if(actual.at(x, y) != expected.at(x, y)) {
+                min_x = std::min(min_x, x);
+                min_y = std::min(min_y, y);
+                max_x = std::max(max_x, x);
+                max_y = std::max(max_y, y);
+            }
+        }
+    }
+
+    min_x = std::max(min_x - 1, 0);
+    min_y = std::max(min_y - 1, 0);
+    max_x = std::min(max_x + 1, input.width() - 1);
+    max_y = std::min(max_y + 1, input.height() - 1);
+
+    gol::board cropped{ max_x - min_x + 1, max_y - min_y + 1 };
+
+    for(int y = 0; y < cropped.height(); ++y) {
+        for(int x = 0; x < cropped.width(); ++x) {
+            cropped.at(x, y) = input.at(min_x + x, min_y + y);
+        }
+    }
+
+    // some bugs depend on where on the board they happen
+    return diverges(candidate, cropped) ? cropped : input;
+}
+
+} // namespace
+
+namespace gol {
+
+auto reference_step(board input, gol::rule const& r, gol::topology const t) -> board
+{
+    scalar_engine reference;
+    board next{ input.width(), input.height() };
+
+    reference.set_rule(r);
+    reference.set_topology(t);
+    reference.step(input, next);
+
+    return next;
+}
+
+auto validate(engine& candidate, board const& initial, int const generations) -> std::optional<divergence>
+{
+    scalar_engine reference;
+    reference.set_rule(candidate.rule());
+    reference.set_topology(candidate.topology());
+
+    board expected = initial;
+    board actual = initial;
+    board expected_next{ initial.width(), initial.height() };
+    board actual_next{ initial.width(), initial.height() };
+
+    for(int generation = 1; generation <= generations; ++generation) {
+        reference.step(expected, expected_next);
+        candidate.step(actual, actual_next);
+
+        if(expected_next.hash() != actual_next.hash()) {
+            return divergence{ generation, candidate.name(), candidate.rule(), candidate.topology(),
+                               minimize(candidate, actual) };
+        }
+
+        std::swap(expected, expected_next);
+        std::swap(actual, actual_next);
+    }
+
+    return std::nullopt;
+}
+
+auto validate_random(engine& candidate, std::uint64_t const seed, int const trials, int const generations)
+    -> std::optional<divergence>
+{
+    constexpr std::uint64_t max_size = 96;
+    constexpr std::uint64_t density_steps = 10;
+
+    std::mt19937_64 rng{ seed };
+
+    for(int trial = 0; trial < trials; ++trial) {
+        auto const width = static_cast<int>(1 + rng() % max_size);
+        auto const height = static_cast<int>(1 + rng() % max_size);
+        auto const density = rng() % density_steps;
+
+        // half the trials use life itself, the rest any rule at all
+        gol::rule r{};
+        if((rng() & 1U) != 0) {
+            r.birth = static_cast<std::uint16_t>(rng() & 0x1FFU);
+            r.survive = static_cast<std::uint16_t>(rng() & 0x1FFU);
+        }
+
+        candidate.set_rule(r);
+        candidate.set_topology((rng() & 1U) != 0 ? topology::torus : topology::bounded);
+
+        board initial{ width, height };
+
+        for(int y = 0; y < height; ++y) {
+            for(int x = 0; x < width; ++x) {
+                initial.at(x, y) = static_cast<unsigned char>(rng() % density_steps < density);
+            }
+        }
+
+        if(auto d = validate(candidate, initial, generations)) {
+            return d;
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto minimize(engine& candidate, board const& input) -> board
+{
+    board minimal = input;
+
+    if(!diverges(candidate, minimal)) {
+        return minimal;
+    }
+
+    // once before so clearing cells is cheap on big boards, once after to drop what the cleared cells left behind
+    minimal = crop(candidate, std::move(minimal));
+
+    for(int y = 0; y < minimal.height(); ++y) {
+        for(int x = 0; x < minimal.width(); ++x) {
+            if(minimal.at(x, y) == board::s_dead) {
+                continue;
+            }
+
+            minimal.at(x, y) = board::s_dead;
+
+            if(!diverges(candidate, minimal)) {
+                minimal.at(x, y) = board::s_alive;
+            }
+        }
+    }
+
+    return crop(candidate, std::move(minimal));
+}
+
+auto write_divergence(std::ostream& out, divergence const& d) -> void
+{
+    out << "!Name: divergence of the " << d.engine << " engine at generation " << d.generation << '\n'
+        << "!Rule: " << to_string(d.rule) << '\n'
+        << "!Topology: " << to_string(d.topology) << '\n';
+
+    for(int y = 0; y < d.input.height(); ++y) {
+        for(int x = 0; x < d.input.width(); ++x) {
+            out << (d.input.at(x, y) == board::s_alive ? 'O' : '.');
+        }
+        out << '\n';
+    }
+}
+
+} // namespace gol
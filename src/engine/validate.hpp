@@ -0,0 +1,45 @@
+#ifndef GOL_ENGINE_VALIDATE_HPP
+#define GOL_ENGINE_VALIDATE_HPP
+#pragma once
+
+#include "board.hpp"
+#include "engine.hpp"
+#include "rule.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace gol {
+
+struct divergence
+{
+    int generation = 0;
+    std::string engine;
+    gol::rule rule{};
+    gol::topology topology = gol::topology::bounded;
+    // one step from this board is enough for the engine to disagree with the reference
+    board input;
+};
+
+// one generation of the reference scalar engine
+[[nodiscard]] auto reference_step(board input, gol::rule const& r, gol::topology t) -> board;
+
+// Steps `candidate` and the reference side by side from `initial`, comparing board hashes after every generation
+[[nodiscard]] auto validate(engine& candidate, board const& initial, int generations) -> std::optional<divergence>;
+
+// Random boards, densities, rules and topologies, `candidate`'s rule and topology are overwritten
+[[nodiscard]] auto validate_random(engine& candidate, std::uint64_t seed, int trials, int generations)
+    -> std::optional<divergence>;
+
+// Crops `input` around the cells `candidate` gets wrong and clears every live cell it can while the engine still
+// disagrees with the reference
+[[nodiscard]] auto minimize(engine& candidate, board const& input) -> board;
+
+// plaintext (.cells) format, with the rule, topology and engine in the header
+auto write_divergence(std::ostream& out, divergence const& d) -> void;
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_VALIDATE_HPP
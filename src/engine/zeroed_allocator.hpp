@@ -0,0 +1,73 @@
+#ifndef GOL_ENGINE_ZEROED_ALLOCATOR_HPP
+#define GOL_ENGINE_ZEROED_ALLOCATOR_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace gol {
+
+// Gets memory from calloc, so big blocks are zero pages straight from the OS that cost nothing until they are
+// touched, and leaves elements constructed without arguments alone because they are zero already. That only holds
+// for freshly allocated storage: don't grow a vector into capacity it used before and expect zeros there.
+template<typename T>
+class zeroed_allocator
+{
+public:
+    static_assert(std::is_trivial_v<T>, "zeroed_allocator is for types that are valid with all bits zero");
+
+    using value_type = T;
+
+    zeroed_allocator() noexcept = default;
+
+    template<typename U>
+    zeroed_allocator(zeroed_allocator<U> const&) noexcept // NOLINT(google-explicit-constructor)
+    {
+    }
+
+    [[nodiscard]] auto allocate(std::size_t const n) -> T*
+    {
+        void* ptr = std::calloc(n, sizeof(T));
+
+        if(ptr == nullptr) {
+            throw std::bad_alloc{};
+        }
+
+        return static_cast<T*>(ptr);
+    }
+
+    auto deallocate(T* const ptr, std::size_t) noexcept -> void
+    {
+        std::free(ptr); // NOLINT
+    }
+
+    template<typename U>
+    auto construct(U*) noexcept -> void
+    {
+    }
+
+    template<typename U, typename... Args>
+    auto construct(U* ptr, Args&&... args) -> void
+    {
+        ::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...); // NOLINT
+    }
+};
+
+template<typename T, typename U>
+[[nodiscard]] auto operator==(zeroed_allocator<T> const&, zeroed_allocator<U> const&) noexcept -> bool
+{
+    return true;
+}
+
+template<typename T, typename U>
+[[nodiscard]] auto operator!=(zeroed_allocator<T> const&, zeroed_allocator<U> const&) noexcept -> bool
+{
+    return false;
+}
+
+} // namespace gol
+
+#endif // !GOL_ENGINE_ZEROED_ALLOCATOR_HPP
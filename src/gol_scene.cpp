@@ -1,14 +1,75 @@
 #include "gol_scene.hpp"
 
 #include "assert.hpp"
+#include "profiler.hpp"
+
+#include "engine/validate.hpp"
+#include "thread/metrics.hpp"
+#include "thread/trace.hpp"
 
 #include <algorithm>
-#include <array>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace {
+
+gol::metric g_generations{ "gol_generations_total", "Generations simulated", gol::metric_kind::counter };
+// in thousandths
+gol::metric g_generations_per_second{ "gol_generations_per_second",
+                                      "Generations simulated over the last second",
+                                      gol::metric_kind::gauge,
+                                      1e-3 };
+gol::metric g_generation{ "gol_generation", "Generation the simulation is at", gol::metric_kind::gauge };
+gol::metric g_active_rows{ "gol_active_rows", "Rows that changed in the last generation", gol::metric_kind::gauge };
+gol::metric g_edit_queue_depth{ "gol_edit_queue_depth",
+                                "Edits that were waiting in the queue when the last generation drained it",
+                                gol::metric_kind::gauge };
+gol::metric g_edits_dropped{ "gol_edits_dropped_total",
+                             "Edits dropped because the queue was full",
+                             gol::metric_kind::counter };
+
+} // namespace
 
 namespace gol {
 
+gol_scene::gol_scene(int const census_every)
+    : m_census_every{ census_every }
+{
+}
+
+gol_scene::gol_scene(std::unique_ptr<gol::engine> e,
+                     int const census_every,
+                     int const validate_every,
+                     int const generations_per_second)
+    : m_engine{ std::move(e) }
+    , m_validate_every{ validate_every }
+    , m_generations_per_second{ generations_per_second }
+    , m_census{ m_engine->rule() }
+    , m_census_every{ census_every }
+{
+    ASSERT(m_engine != nullptr);
+}
+
+gol_scene::~gol_scene() noexcept
+{
+    {
+        std::lock_guard<std::mutex> const lock{ m_stop_mutex };
+        m_stop.store(true, std::memory_order_release);
+    }
+    m_stop_cv.notify_all();
+
+    // the simulation uses most of the members, stop it before any of them go away
+    if(m_future.valid()) {
+        m_future.get();
+    }
+}
+
 auto gol_scene::cell_at(coord const pos) noexcept -> unsigned char&
 {
     ASSERT(pos.x >= 0);
@@ -16,44 +77,211 @@ auto gol_scene::cell_at(coord const pos) noexcept -> unsigned char&
     ASSERT(pos.x < m_width);
     ASSERT(pos.y < m_height);
 
-    return m_grid[static_cast<std::size_t>(pos.y + 1) * static_cast<std::size_t>(m_width + 1) +
-                  static_cast<std::size_t>(pos.x + 1)];
+    return m_grid.at(pos.x, pos.y);
 }
 
-auto gol_scene::cell_at(coord const pos) const noexcept -> unsigned char const&
+auto gol_scene::cell_at(coord const pos) const noexcept -> unsigned char
 {
-    ASSERT(pos.x >= -1);
-    ASSERT(pos.y >= -1);
-    ASSERT(pos.x <= m_width);
-    ASSERT(pos.y <= m_height);
+    ASSERT(pos.x >= 0);
+    ASSERT(pos.y >= 0);
+    ASSERT(pos.x < m_width);
+    ASSERT(pos.y < m_height);
 
-    return m_grid[static_cast<std::size_t>(pos.y + 1) * static_cast<std::size_t>(m_width + 1) +
-                  static_cast<std::size_t>(pos.x + 1)];
+    return m_grid.at(pos.x, pos.y);
 }
 
-auto gol_scene::initialize_grid(std::vector<coord> const& initial_alive_cells) noexcept -> void
+auto gol_scene::snapshot() const -> std::vector<unsigned char>
 {
-    m_grid.resize(static_cast<std::size_t>(m_width + 2) * static_cast<std::size_t>(m_height + 2));
-    std::fill(m_grid.begin(), m_grid.end(), s_dead);
+    std::vector<unsigned char> grid(static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height));
+
+    for(int i = 0; i < m_height; ++i) {
+        for(int j = 0; j < m_width; ++j) {
+            grid[static_cast<std::size_t>(i) * static_cast<std::size_t>(m_width) + static_cast<std::size_t>(j)] =
+                this->cell_at({ j, i });
+        }
+    }
+
+    return grid;
+}
 
-    for(coord const& pos : initial_alive_cells) {
-        this->cell_at(pos) = s_alive;
+auto gol_scene::start_census() -> void
+{
+    // still busy with the previous one, try again next generation
+    if(m_census_future.valid() &&
+       m_census_future.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready) {
+        return;
     }
+
+    m_census_requested = false;
+    m_census_future =
+        m_census_threadpool.push([this, generation = m_generation, grid = this->snapshot()]() noexcept -> void {
+            auto const counts = m_census.run(grid, m_width, m_height);
+
+            std::vector<std::pair<std::string, int>> sorted{ counts.begin(), counts.end() };
+            std::stable_sort(sorted.begin(), sorted.end(), [](auto const& a, auto const& b) {
+                return a.second > b.second;
+            });
+
+            std::cout << "Census at generation " << generation << ":\n";
+            for(auto const& [name, count] : sorted) {
+                std::cout << "    " << count << ' ' << name << '\n';
+            }
+            std::cout << std::flush;
+        });
 }
 
-auto gol_scene::count_at(coord const pos) const noexcept -> int
+auto gol_scene::start_validation() -> void
 {
-    std::array<coord, 8> const neighbors = { coord{ pos.x - 1, pos.y - 1 }, coord{ pos.x, pos.y - 1 },
-                                             coord{ pos.x + 1, pos.y - 1 }, coord{ pos.x - 1, pos.y },
-                                             coord{ pos.x + 1, pos.y },     coord{ pos.x - 1, pos.y + 1 },
-                                             coord{ pos.x, pos.y + 1 },     coord{ pos.x + 1, pos.y + 1 } };
-    int count = 0;
+    // still busy with the previous one, this generation goes unchecked
+    if(m_validate_future.valid() &&
+       m_validate_future.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready) {
+        return;
+    }
+
+    m_validate_future = m_validate_threadpool.push([input = m_sim_grid,
+                                                    hash = m_next.hash(),
+                                                    name = m_engine->name(),
+                                                    r = m_engine->rule(),
+                                                    t = m_engine->topology(),
+                                                    generation = m_sim_generation]() -> void {
+        if(gol::reference_step(input, r, t).hash() == hash) {
+            return;
+        }
+
+        // a fresh engine of the same kind, the running one belongs to the simulation
+        auto candidate = gol::make_engine(name, std::max(1U, std::thread::hardware_concurrency()));
+        candidate->set_rule(r);
+        candidate->set_topology(t);
+
+        gol::divergence const d{ static_cast<int>(generation), name, r, t, gol::minimize(*candidate, input) };
+        auto const path = "divergence-gen" + std::to_string(generation) + ".cells";
+        std::ofstream out{ path };
+        gol::write_divergence(out, d);
+
+        ERROR("[GOL Scene] The {} engine diverged from the reference at generation {}, input written to {}",
+              name,
+              generation,
+              path);
+    });
+}
+
+auto gol_scene::publish() noexcept -> void
+{
+    gol::trace_span const span{ "snapshot publish" };
+
+    auto& back = m_snapshots.back();
+
+    // it's a few generations old, only the rows changed since then need copying
+    for(int y = 0; y < m_height; ++y) {
+        auto const row = static_cast<std::size_t>(y);
+
+        if(m_row_generation[row] > back.generation) {
+            std::copy(m_sim_grid.row(y), m_sim_grid.row(y) + m_width, back.grid.row(y));
+            back.row_generation[row] = m_row_generation[row];
+        }
+    }
+
+    back.generation = m_sim_generation;
+    m_snapshots.publish();
+}
+
+auto gol_scene::simulate() -> void
+{
+    using clock = std::chrono::steady_clock;
+
+    auto const period = m_generations_per_second > 0
+                            ? std::chrono::duration_cast<clock::duration>(std::chrono::seconds{ 1 }) /
+                                  m_generations_per_second
+                            : clock::duration::zero();
+    auto next_generation = clock::now();
+    auto rate_start = next_generation;
+    long rate_generations = 0;
+
+    while(!m_stop.load(std::memory_order_acquire)) {
+        if(m_generations_per_frame > 0) {
+            std::unique_lock<std::mutex> lock{ m_stop_mutex };
+            m_stop_cv.wait(lock, [this] {
+                return m_stop.load(std::memory_order_acquire) || m_sim_generation < m_target_generation;
+            });
+
+            if(m_stop.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+        else if(period > clock::duration::zero()) {
+            std::unique_lock<std::mutex> lock{ m_stop_mutex };
+            m_stop_cv.wait_until(lock, next_generation, [this] { return m_stop.load(std::memory_order_acquire); });
+
+            // after a stall, carry on at the normal pace instead of catching up in a burst
+            next_generation = std::max(next_generation + period, clock::now());
+        }
+
+        {
+            gol::scoped_timer const timer{ phase::generation };
+            m_engine->step(m_sim_grid, m_next);
+        }
+
+        ++m_sim_generation;
+        ++rate_generations;
+
+        if(m_validate_every > 0 && m_sim_generation % m_validate_every == 0) {
+            this->start_validation();
+        }
+
+        // edits land on top of this generation so they always win and show up next frame
+        std::pair<coord, bool> edit;
+        int num_edits = 0;
+        while(m_edits.pop(edit)) {
+            m_next.at(edit.first.x, edit.first.y) = edit.second ? gol::board::s_alive : gol::board::s_dead;
+            ++num_edits;
+        }
 
-    for(auto const& neighbor : neighbors) {
-        count += this->cell_at(neighbor);
+        int changed_rows = 0;
+
+        for(int y = 0; y < m_height; ++y) {
+            if(!std::equal(m_sim_grid.row(y), m_sim_grid.row(y) + m_width, m_next.row(y))) {
+                m_row_generation[static_cast<std::size_t>(y)] = m_sim_generation;
+                ++changed_rows;
+            }
+        }
+
+        std::swap(m_sim_grid, m_next);
+        this->publish();
+
+        if(m_generations_per_frame > 0) {
+            {
+                std::lock_guard<std::mutex> const lock{ m_stop_mutex };
+                m_published_generation = m_sim_generation;
+            }
+            m_stop_cv.notify_all();
+        }
+
+        // an idle window sleeps until there's something new to show
+        if(changed_rows > 0) {
+            m_window->wake();
+        }
+
+        g_generations.increment();
+        g_generation.set(m_sim_generation);
+        g_active_rows.set(changed_rows);
+        g_edit_queue_depth.set(num_edits);
+
+        if(auto const now = clock::now(); now - rate_start >= std::chrono::seconds{ 1 }) {
+            constexpr double thousandths = 1000.0;
+            auto const seconds = std::chrono::duration<double>(now - rate_start).count();
+
+            g_generations_per_second.set(
+                static_cast<std::int64_t>(static_cast<double>(rate_generations) * thousandths / seconds));
+            rate_start = now;
+            rate_generations = 0;
+        }
     }
+}
 
-    return count;
+auto gol_scene::step_per_frame(int const generations) noexcept -> void
+{
+    ASSERT(!m_future.valid());
+    m_generations_per_frame = generations;
 }
 
 auto gol_scene::setup_event_handling(sdl::window& window, gol::view& view) noexcept -> void
@@ -61,13 +289,27 @@ auto gol_scene::setup_event_handling(sdl::window& window, gol::view& view) noexc
     m_width = view.width();
     m_height = view.height();
 
-    auto const& cells = view.get_initial_alive_cells();
-    this->initialize_grid(std::vector<coord>{ cells.begin(), cells.end() });
+    // fresh boards are zero pages, only the initial cells get written
+    m_grid = gol::board{ m_width, m_height };
+    view.get_initial_alive_cells().copy_to(m_grid);
+    m_sim_grid = m_engine->make_board(m_width, m_height);
+    view.get_initial_alive_cells().copy_to(m_sim_grid);
+    m_next = m_engine->make_board(m_width, m_height);
+    m_changes = gol::change_set{ m_width, m_height };
+    m_row_generation.assign(static_cast<std::size_t>(m_height), 0);
+
+    // the snapshots look older than every row, so the first publish() into each of them copies the whole board on
+    // the simulation thread instead of the window waiting for three copies here
+    m_snapshots.generate([this] {
+        return grid_snapshot{
+            gol::board{ m_width, m_height }, std::vector<long>(static_cast<std::size_t>(m_height), -1), -1
+        };
+    });
 
     m_window = &window;
     m_view = &view;
 
-    m_future = m_threadpool.push([] {});
+    m_future = m_threadpool.push([this] { this->simulate(); });
 
     window.on_key_press([this, &window, &view](sdl::key_event const ev) noexcept -> void {
         switch(ev) {
@@ -99,6 +341,22 @@ auto gol_scene::setup_event_handling(sdl::window& window, gol::view& view) noexc
             view.translate({ 0.0F, 0.0F, -s_translate_offset * m_elapsed });
             break;
         }
+        case sdl::key_event::vk_c: {
+            m_census_requested = true;
+            break;
+        }
+        case sdl::key_event::vk_m: {
+            gol::request_memory_report();
+            break;
+        }
+        case sdl::key_event::vk_e: {
+            m_edit_mode = !m_edit_mode;
+            m_dragging = false;
+            m_drawing = false;
+            m_erasing = false;
+            TRACE("[GOL Scene] Edit mode: {}", m_edit_mode);
+            break;
+        }
         default: {
             break;
         }
@@ -107,6 +365,10 @@ auto gol_scene::setup_event_handling(sdl::window& window, gol::view& view) noexc
 
     window.on_left_click([this](sdl::mouse_coord_t const c) noexcept -> void {
         TRACE("[GOL Scene] Left click at (x={}, y={})", c.first, c.second);
+        if(m_edit_mode) {
+            m_drawing = true;
+            return;
+        }
         m_dragging = true;
         m_last_mouse_coord = { c.first, c.second };
     });
@@ -114,6 +376,19 @@ auto gol_scene::setup_event_handling(sdl::window& window, gol::view& view) noexc
     window.on_left_click_up([this]([[maybe_unused]] sdl::mouse_coord_t const c) noexcept -> void {
         TRACE("[GOL Scene] Left click released at (x={}, y={})", c.first, c.second);
         m_dragging = false;
+        m_drawing = false;
+        m_last_edit_coord = { -1, -1 };
+    });
+
+    window.on_right_click([this]([[maybe_unused]] sdl::mouse_coord_t const c) noexcept -> void {
+        TRACE("[GOL Scene] Right click at (x={}, y={})", c.first, c.second);
+        m_erasing = m_edit_mode;
+    });
+
+    window.on_right_click_up([this]([[maybe_unused]] sdl::mouse_coord_t const c) noexcept -> void {
+        TRACE("[GOL Scene] Right click released at (x={}, y={})", c.first, c.second);
+        m_erasing = false;
+        m_last_edit_coord = { -1, -1 };
     });
 
     window.on_scroll([this, &view](sdl::mouse_coord_t const c) noexcept -> void {
@@ -122,10 +397,27 @@ auto gol_scene::setup_event_handling(sdl::window& window, gol::view& view) noexc
 
     window.on_resize([&view](int const w, int const h) noexcept -> void {
         TRACE("[GOL Scene] Window resized: w={}, h={}", w, h);
-        view.set_aspect_ratio(static_cast<float>(w) / static_cast<float>(h));
+        view.set_viewport(w, h);
     });
 }
 
+auto gol_scene::queue_edit() noexcept -> void
+{
+    auto const [x, y] = m_window->get_mouse_coord();
+    auto const pos = m_view->screen_to_grid(x, y, m_window->width(), m_window->height());
+
+    if(pos == m_last_edit_coord || pos.x < 0 || pos.x >= m_width || pos.y < 0 || pos.y >= m_height) {
+        return;
+    }
+
+    m_last_edit_coord = pos;
+
+    if(!m_edits.push({ pos, m_drawing })) {
+        g_edits_dropped.increment();
+        WARN("[GOL Scene] Edit queue full, dropping edit at (x={}, y={})", pos.x, pos.y);
+    }
+}
+
 auto gol_scene::update(float const elapsed) noexcept -> void
 {
     m_elapsed = elapsed;
@@ -133,49 +425,60 @@ auto gol_scene::update(float const elapsed) noexcept -> void
     ASSERT(m_window != nullptr);
     ASSERT(m_view != nullptr);
 
-    static constexpr int cell_target_die = 2;
-    static constexpr int cell_target_live = 3;
+    if(m_drawing || m_erasing) {
+        this->queue_edit();
+    }
 
-    m_future.get();
+    // the edit just queued lands in the first of this frame's generations, and they're all shown below
+    if(m_generations_per_frame > 0) {
+        std::unique_lock<std::mutex> lock{ m_stop_mutex };
+        m_target_generation += m_generations_per_frame;
+        m_stop_cv.notify_all();
+        m_stop_cv.wait(lock, [this] { return m_published_generation >= m_target_generation; });
+    }
 
-    std::vector<std::pair<coord, bool>> ev;
+    bool fresh = false;
 
-    if(m_events.pop(ev)) {
-        for(auto& event : ev) {
-            if(event.second) {
-                this->cell_at(event.first) = s_alive;
-                m_view->set_alive(event.first);
-            }
-            else {
-                this->cell_at(event.first) = s_dead;
-                m_view->set_dead(event.first);
-            }
-        }
+    {
+        gol::trace_span const span{ "snapshot update" };
+        fresh = m_snapshots.update();
     }
 
-    m_future = m_threadpool.push([this] {
-        static std::vector<std::pair<coord, bool>> events;
+    if(fresh) {
+        auto const& snapshot = m_snapshots.front();
 
-        for(int i = 0; i < m_height; ++i) {
-            for(int j = 0; j < m_width; ++j) {
-                auto const count = this->count_at({ j, i });
-                bool const alive = this->cell_at({ j, i }) == s_alive;
+        {
+            gol::scoped_timer const timer{ phase::apply };
 
-                if(alive && ((count < cell_target_die) || (count > cell_target_live))) {
-                    events.emplace_back(coord{ j, i }, false);
-                }
-                else if(!alive && count == cell_target_live) {
-                    events.emplace_back(coord{ j, i }, true);
+            for(int y = 0; y < m_height; ++y) {
+                if(snapshot.row_generation[static_cast<std::size_t>(y)] > m_generation) {
+                    m_changes.record_row(y, m_grid, snapshot.grid);
                 }
             }
+
+            m_changes.apply(m_grid);
+            m_view->apply(m_changes, m_grid);
         }
 
-        while(!m_events.push(events)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        m_changes.clear();
+
+        // generations in between may have been skipped, so look for a crossed multiple rather than an exact one
+        if(m_census_every > 0 && snapshot.generation / m_census_every > m_generation / m_census_every) {
+            m_census_requested = true;
         }
 
-        events.clear();
-    });
+        m_generation = snapshot.generation;
+    }
+
+    // what didn't fit in the upload budget last frame goes out even without a new snapshot
+    if(m_view->upload_pending()) {
+        gol::scoped_timer const timer{ phase::upload };
+        static_cast<void>(m_view->upload(m_grid));
+    }
+
+    if(m_census_requested) {
+        this->start_census();
+    }
 
     if(m_dragging) {
         auto const tmp = m_window->get_mouse_coord();
@@ -204,6 +507,48 @@ auto gol_scene::update(float const elapsed) noexcept -> void
     }
 }
 
+auto gol_scene::estimate_memory(int const w, int const h, bool const validating, memory_report& report) -> void
+{
+    auto const board_bytes = gol::board::memory_usage(w, h);
+    auto const row_generations = static_cast<std::size_t>(h) * sizeof(long);
+
+    report.add("game", "shown board", board_bytes);
+    report.add("game", "changes to show (change set)", gol::change_set::memory_usage(w, h));
+    report.add("game", "simulation boards (2)", 2 * board_bytes);
+    report.add("game", "row generations", row_generations);
+    report.add("game", "snapshots (3)", 3 * (board_bytes + row_generations));
+    report.add("game", "edit queue", sizeof(decltype(m_edits)));
+    report.add("game", "census copy, while counting", static_cast<std::size_t>(w) * static_cast<std::size_t>(h));
+    report.add("game", "census labels, while counting", gol::census::memory_usage(w, h));
+
+    if(validating) {
+        // the input, the reference's copy of it and its result
+        report.add("game", "validation boards, while checking", 3 * board_bytes);
+    }
+}
+
+auto gol_scene::report_memory(memory_report& report) const -> void
+{
+    auto const row_generations = m_row_generation.capacity() * sizeof(long);
+    // the simulation swaps its boards around while this runs, but they are all as big as the shown board
+    auto const board_bytes = m_grid.memory_usage();
+    auto const snapshots = 3 * (board_bytes + row_generations);
+
+    report.add("game", "shown board", board_bytes);
+    report.add("game", "changes to show (change set)", m_changes.memory_usage());
+    report.add("game", "simulation boards (2)", 2 * board_bytes);
+    report.add("game", "row generations", row_generations);
+    report.add("game", "snapshots (3)", snapshots);
+    report.add("game", "edit queue", sizeof(m_edits));
+    report.add(
+        "game", "census copy, while counting", static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height));
+    report.add("game", "census labels, while counting", gol::census::memory_usage(m_width, m_height));
+
+    if(m_validate_every > 0) {
+        report.add("game", "validation boards, while checking", 3 * board_bytes);
+    }
+}
+
 auto gol_scene::finished() const noexcept -> bool
 {
     return m_finished;
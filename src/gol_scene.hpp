@@ -2,12 +2,23 @@
 #define GOL_GOL_SCENE_HPP
 #pragma once
 
+#include "census.hpp"
 #include "coord.hpp"
 #include "scene.hpp"
 
-#include "thread/ring_buffer.hpp"
+#include "engine/board.hpp"
+#include "engine/change_set.hpp"
+#include "engine/engine.hpp"
+
+#include "thread/mpsc_queue.hpp"
 #include "thread/thread_pool.hpp"
+#include "thread/triple_buffer.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -17,41 +28,102 @@ class gol_scene : public scene
 {
 private:
     static constexpr int s_translate_offset = 10.0F;
-    static constexpr unsigned char s_alive = 1;
-    static constexpr unsigned char s_dead = 0;
-    static constexpr int s_max_num_events = 51;
+    static constexpr std::size_t s_max_num_edits = 4096;
+
+    // a complete generation as published by the simulation
+    struct grid_snapshot
+    {
+        gol::board grid;
+        // the generation each row last changed in, so readers can skip the rows they're already up to date on
+        std::vector<long> row_generation;
+        long generation = 0;
+    };
 
-    std::vector<unsigned char> m_grid;
-    // m_events[i].second == true <=> set_alive
-    gol::ring_buffer<std::vector<std::pair<coord, bool>>, s_max_num_events> m_events;
+    // what's on screen, only touched by the main thread
+    gol::board m_grid;
+    // the cells that differ between m_grid and the newest snapshot
+    gol::change_set m_changes;
+    // only touched by the simulation
+    gol::board m_sim_grid;
+    gol::board m_next;
+    std::vector<long> m_row_generation;
+    // declared before m_threadpool so the simulation stops before its engine goes away
+    std::unique_ptr<gol::engine> m_engine = std::make_unique<gol::sliding_engine>();
+    gol::triple_buffer<grid_snapshot> m_snapshots;
+    // user edits, drained by the simulation at the end of every generation
+    gol::mpsc_queue<std::pair<coord, bool>, s_max_num_edits> m_edits;
+    // declared before m_threadpool, the simulation may still hand it a check while shutting down
+    gol::threadpool m_validate_threadpool{ 1 };
+    std::future<void> m_validate_future;
+    int m_validate_every = 0;
+    long m_sim_generation = 0;
+    // 0 runs the simulation as fast as it goes
+    int m_generations_per_second = 60;
+    // > 0 steps exactly this many generations per update() instead of following the clock
+    int m_generations_per_frame = 0;
+    std::atomic<bool> m_stop{ false };
+    // also guards the two generations below
+    std::mutex m_stop_mutex;
+    std::condition_variable m_stop_cv;
+    // with m_generations_per_frame, how far update() let the simulation go and how far it got
+    long m_target_generation = 0;
+    long m_published_generation = 0;
     gol::threadpool m_threadpool{ 1 };
     std::future<void> m_future;
+    gol::census m_census;
+    // declared after m_census so it's joined before the census it runs on goes away
+    gol::threadpool m_census_threadpool{ 1 };
+    std::future<void> m_census_future;
+    int m_census_every = 0;
+    bool m_census_requested = false;
+    long m_generation = 0;
     int m_width = 0;
     int m_height = 0;
     sdl::window* m_window = nullptr;
     gol::view* m_view = nullptr;
     float m_elapsed = 0.0F;
     gol::coord m_last_mouse_coord = { 0, 0 };
+    gol::coord m_last_edit_coord = { -1, -1 };
     bool m_dragging = false;
+    bool m_edit_mode = false;
+    bool m_drawing = false;
+    bool m_erasing = false;
     bool m_finished = false;
 
-    auto initialize_grid(std::vector<coord> const& initial_alive_cells) noexcept -> void;
     [[nodiscard]] auto cell_at(coord pos) noexcept -> unsigned char&;
-    [[nodiscard]] auto cell_at(coord pos) const noexcept -> unsigned char const&;
-    [[nodiscard]] auto count_at(coord pos) const noexcept -> int;
+    [[nodiscard]] auto cell_at(coord pos) const noexcept -> unsigned char;
+    auto queue_edit() noexcept -> void;
+    [[nodiscard]] auto snapshot() const -> std::vector<unsigned char>;
+    auto start_census() -> void;
+    // the simulation thread's loop, runs until m_stop
+    auto simulate() -> void;
+    auto publish() noexcept -> void;
+    // runs on the simulation thread, right after m_next was computed from m_sim_grid
+    auto start_validation() -> void;
 
 public:
     gol_scene() = default;
+    explicit gol_scene(int census_every);
+    // `validate_every` > 0 checks every Nth generation of `e` against the reference engine on a spare thread
+    gol_scene(std::unique_ptr<gol::engine> e, int census_every, int validate_every, int generations_per_second);
     gol_scene(gol_scene const&) = delete;
     gol_scene(gol_scene&&) noexcept = delete;
-    ~gol_scene() noexcept override = default;
+    ~gol_scene() noexcept override;
 
     auto operator=(gol_scene const&) -> gol_scene& = delete;
     auto operator=(gol_scene&&) noexcept -> gol_scene& = delete;
 
+    // Steps `generations` per frame and has every frame wait for them, so the generations edits land in and what
+    // each frame shows don't depend on timing. Called before the scene starts.
+    auto step_per_frame(int generations) noexcept -> void;
+
     auto setup_event_handling(sdl::window& window, gol::view& view) noexcept -> void override;
     auto update(float elapsed) noexcept -> void override;
     [[nodiscard]] auto finished() const noexcept -> bool override;
+    auto report_memory(memory_report& report) const -> void override;
+
+    // what the scene allocates for a w x h board, once it starts
+    static auto estimate_memory(int w, int h, bool validating, memory_report& report) -> void;
 };
 
 } // namespace gol
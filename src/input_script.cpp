@@ -0,0 +1,103 @@
+#include "input_script.hpp"
+
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace {
+
+constexpr std::array<char const*, 9> g_kind_names = {
+    "key", "left_click", "left_click_up", "right_click", "right_click_up", "scroll", "resize", "mouse", "quit"
+};
+
+constexpr std::array<char const*, 16> g_key_names = { "escape", "space", "up", "down", "left", "right", "w", "s",
+                                                      "e",      "c",     "f",  "x",    "r",    "p",     "m", "none" };
+
+static_assert(g_kind_names.size() == static_cast<std::size_t>(sdl::input_kind::quit) + 1);
+static_assert(g_key_names.size() == static_cast<std::size_t>(sdl::key_event::vk_none) + 1);
+
+template<std::size_t N>
+[[nodiscard]] auto find_name(std::array<char const*, N> const& names, std::string const& name) -> std::optional<int>
+{
+    for(std::size_t i = 0; i < N; ++i) {
+        if(name == names[i]) {
+            return static_cast<int>(i);
+        }
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+namespace sdl {
+
+auto write_event(std::ostream& out, input_event const& ev) -> void
+{
+    out << ev.frame << ' ' << ev.time_ms << ' ' << g_kind_names.at(static_cast<std::size_t>(ev.kind));
+
+    switch(ev.kind) {
+    case input_kind::key_press: {
+        out << ' ' << g_key_names.at(static_cast<std::size_t>(ev.a));
+        break;
+    }
+    case input_kind::quit: {
+        break;
+    }
+    default: {
+        out << ' ' << ev.a << ' ' << ev.b;
+        break;
+    }
+    }
+
+    out << '\n';
+}
+
+auto read_script(std::istream& in) -> std::optional<std::vector<input_event>>
+{
+    std::vector<input_event> script;
+    std::string line;
+
+    while(std::getline(in, line)) {
+        if(line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        std::istringstream fields{ line };
+        input_event ev;
+        std::string kind;
+
+        if(!(fields >> ev.frame >> ev.time_ms >> kind)) {
+            return std::nullopt;
+        }
+
+        auto const k = find_name(g_kind_names, kind);
+        if(!k.has_value()) {
+            return std::nullopt;
+        }
+
+        ev.kind = static_cast<input_kind>(*k);
+
+        if(ev.kind == input_kind::key_press) {
+            std::string key;
+            fields >> key;
+
+            auto const id = find_name(g_key_names, key);
+            if(!id.has_value()) {
+                return std::nullopt;
+            }
+
+            ev.a = *id;
+        }
+        else if(ev.kind != input_kind::quit && !(fields >> ev.a >> ev.b)) {
+            return std::nullopt;
+        }
+
+        script.push_back(ev);
+    }
+
+    return script;
+}
+
+} // namespace sdl
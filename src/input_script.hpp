@@ -0,0 +1,67 @@
+#ifndef GOL_INPUT_SCRIPT_HPP
+#define GOL_INPUT_SCRIPT_HPP
+#pragma once
+
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace sdl {
+
+enum class key_event
+{
+    vk_escape,
+    vk_space,
+    vk_up,
+    vk_down,
+    vk_left,
+    vk_right,
+    vk_w,
+    vk_s,
+    vk_e,
+    vk_c,
+    vk_f,
+    vk_x,
+    vk_r,
+    vk_p,
+    vk_m,
+    vk_none
+};
+
+using mouse_coord_t = std::pair<int, int>;
+
+enum class input_kind
+{
+    key_press,      // a is the key_event
+    left_click,     // (a, b) is where
+    left_click_up,  // (a, b) is where
+    right_click,    // (a, b) is where
+    right_click_up, // (a, b) is where
+    scroll,         // (a, b) is how much
+    resize,         // (a, b) is the new size
+    mouse,          // the mouse moved to (a, b)
+    quit
+};
+
+// One call of a window callback, or a change of what get_mouse_coord() returns
+struct input_event
+{
+    // handle_events() call it happened in, counted from 1
+    long frame = 0;
+    // since the recording started, only there for whoever reads the file
+    double time_ms = 0.0;
+    input_kind kind = input_kind::quit;
+    int a = 0;
+    int b = 0;
+};
+
+// One line per event: `<frame> <time_ms> <kind> [args]`, with keys by name so recordings survive changes to key_event
+auto write_event(std::ostream& out, input_event const& ev) -> void;
+// nullopt at the first line that doesn't parse, lines starting with '#' are comments
+[[nodiscard]] auto read_script(std::istream& in) -> std::optional<std::vector<input_event>>;
+
+} // namespace sdl
+
+#endif // !GOL_INPUT_SCRIPT_HPP
@@ -1,7 +1,35 @@
 #include "log.hpp"
 
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
 #include <array>
 
+namespace {
+
+[[nodiscard]] auto to_spdlog(logging::level const severity) noexcept -> spdlog::level::level_enum
+{
+    switch(severity) {
+    case logging::level::trace:
+        return spdlog::level::trace;
+    case logging::level::info:
+        return spdlog::level::info;
+    case logging::level::warn:
+        return spdlog::level::warn;
+    case logging::level::error:
+        return spdlog::level::err;
+    case logging::level::fatal:
+        return spdlog::level::critical;
+    case logging::level::off:
+        break;
+    }
+
+    return spdlog::level::off;
+}
+
+} // namespace
+
 namespace logging {
 
 logger::logger()
@@ -10,16 +38,95 @@ logger::logger()
                                               std::make_shared<spdlog::sinks::basic_file_sink_mt>(
                                                   "GameOfLife.txt", /* truncate: */ true) };
 
-    m_logger = std::make_shared<spdlog::logger>("GameOfLife", sinks.begin(), sinks.end());
-    spdlog::register_logger(m_logger);
-    m_logger->set_level(spdlog::level::trace);
-    m_logger->flush_on(spdlog::level::trace);
+    m_sink = std::make_shared<spdlog::logger>("GameOfLife", sinks.begin(), sinks.end());
+    spdlog::register_logger(m_sink);
+    // filtering already happened when the message was recorded
+    m_sink->set_level(spdlog::level::trace);
+    m_sink->flush_on(spdlog::level::trace);
+
+    m_writer = std::thread{ [this] {
+        std::unique_lock<std::mutex> lock{ m_mutex };
+
+        while(!m_stop) {
+            m_cv.wait_for(
+                lock, s_idle_timeout, [this] { return m_stop || m_pending.load(std::memory_order_acquire); });
+
+            // cleared before draining, a message recorded from here on sets it again and gets another round
+            static_cast<void>(m_pending.exchange(false, std::memory_order_acq_rel));
+
+            lock.unlock();
+            this->drain();
+            lock.lock();
+        }
+    } };
+}
+
+logger::~logger() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_writer.join();
+
+    // whatever got recorded while the writer was shutting down
+    this->flush();
 }
 
-auto logger::get() noexcept -> std::shared_ptr<spdlog::logger>&
+auto logger::get() noexcept -> logger&
 {
     static logger inst;
-    return inst.m_logger;
+    return inst;
+}
+
+auto logger::set_level(level const severity) noexcept -> void
+{
+    s_level.store(severity, std::memory_order_relaxed);
+}
+
+auto logger::push(message const& m) noexcept -> void
+{
+    static_cast<void>(m_recorder.push(m));
+
+    try {
+        if(!m_pending.exchange(true, std::memory_order_acq_rel)) {
+            // the writer is either about to look at m_pending or already asleep, not in between
+            {
+                std::lock_guard<std::mutex> const lock{ m_mutex };
+            }
+            m_cv.notify_one();
+        }
+
+        if(m.severity >= level::error) {
+            this->flush();
+        }
+    }
+    catch(...) {
+        // nowhere left to report it, the writer still gets to the message within s_idle_timeout
+    }
+}
+
+auto logger::drain() -> void
+{
+    std::lock_guard<std::mutex> const drain_lock{ m_drain_mutex };
+
+    m_batch.clear();
+    auto const dropped = m_recorder.drain(m_batch);
+
+    for(auto const& batched : m_batch) {
+        m_sink->log(batched.time, spdlog::source_loc{}, to_spdlog(batched.severity), to_text(batched));
+    }
+
+    if(dropped > 0) {
+        m_sink->warn("{} log messages were dropped, their thread's buffer was full", dropped);
+    }
+}
+
+auto logger::flush() -> void
+{
+    this->drain();
+    m_sink->flush();
 }
 
 } // namespace logging
@@ -2,50 +2,104 @@
 #define GOL_LOG_HPP
 #pragma once
 
-#include <spdlog/sinks/basic_file_sink.h>
-#include <spdlog/sinks/stdout_color_sinks.h>
-#include <spdlog/spdlog.h>
+#include "log_message.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spdlog {
+class logger;
+} // namespace spdlog
 
 namespace logging {
 
-struct logger
+// Every thread records its messages, as the format string and the raw arguments, into its own lock-free ring buffer.
+// A background thread, asleep while nothing is logged, turns them into text and writes them to the console and
+// GameOfLife.txt. Messages below the level cost an atomic load, the rest a copy into the ring. Errors and worse are
+// written before the call returns, since they are often the last thing before an exit.
+class logger
 {
 private:
-    std::shared_ptr<spdlog::logger> m_logger;
+    // the writer sleeps until a message arrives, this only covers a wakeup that got lost anyway
+    static constexpr auto s_idle_timeout = std::chrono::seconds{ 1 };
+
+#ifdef GOL_DEBUG
+    static constexpr level s_default_level = level::trace;
+#else
+    static constexpr level s_default_level = level::info;
+#endif
+
+    static inline std::atomic<level> s_level{ s_default_level };
+
+    recorder m_recorder;
+    // set by the first message since the writer last looked, which is the only one that wakes it up
+    std::atomic<bool> m_pending{ false };
+    // guards the writer's sleep
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    // the side that drains m_recorder, held by the writer or by whoever flushes
+    std::mutex m_drain_mutex;
+    std::vector<message> m_batch;
+    std::shared_ptr<spdlog::logger> m_sink;
+    std::thread m_writer;
+    bool m_stop = false;
 
     logger();
 
+    auto push(message const& m) noexcept -> void;
+    auto drain() -> void;
+
 public:
     logger(logger const&) = delete;
     logger(logger&&) noexcept = delete;
-    ~logger() noexcept = default;
+    ~logger() noexcept;
 
     auto operator=(logger const&) -> logger& = delete;
     auto operator=(logger&&) noexcept -> logger& = delete;
 
-    [[nodiscard]] static auto get() noexcept -> std::shared_ptr<spdlog::logger>&;
-};
+    [[nodiscard]] static auto get() noexcept -> logger&;
 
-} // namespace logging
+    [[nodiscard]] static auto enabled(level const severity) noexcept -> bool
+    {
+        return severity >= s_level.load(std::memory_order_relaxed);
+    }
 
-#ifdef GOL_DEBUG
+    static auto set_level(level severity) noexcept -> void;
 
-#define TRACE(...) ::logging::logger::get()->trace(__VA_ARGS__)
-#define INFO(...) ::logging::logger::get()->info(__VA_ARGS__)
-#define WARN(...) ::logging::logger::get()->warn(__VA_ARGS__)
-#define ERROR(...) ::logging::logger::get()->error(__VA_ARGS__)
-#define FATAL(...) ::logging::logger::get()->critical(__VA_ARGS__)
+    template<typename... Args>
+    auto write(level const severity, char const* format, Args const&... args) noexcept -> void
+    {
+        static_assert(sizeof...(Args) <= message::s_max_args, "Too many arguments for one log message");
 
-#else
+        message m;
+        m.format = format;
+        m.severity = severity;
+        m.time = std::chrono::system_clock::now();
+        (append(m, args), ...);
 
-#define TRACE(...) static_cast<void>(0)
-#define INFO(...) static_cast<void>(0)
-#define WARN(...) static_cast<void>(0)
-#define ERROR(...) static_cast<void>(0)
-#define FATAL(...) static_cast<void>(0)
+        this->push(m);
+    }
 
-#endif
+    // writes out everything recorded so far by every thread
+    auto flush() -> void;
+};
+
+} // namespace logging
+
+// `format` must be a string literal
+#define GOL_LOG(severity, ...)                                                                                         \
+    (::logging::logger::enabled(severity) ? ::logging::logger::get().write(severity, __VA_ARGS__)                      \
+                                          : static_cast<void>(0))
+
+#define TRACE(...) GOL_LOG(::logging::level::trace, __VA_ARGS__)
+#define INFO(...) GOL_LOG(::logging::level::info, __VA_ARGS__)
+#define WARN(...) GOL_LOG(::logging::level::warn, __VA_ARGS__)
+#define ERROR(...) GOL_LOG(::logging::level::error, __VA_ARGS__)
+#define FATAL(...) GOL_LOG(::logging::level::fatal, __VA_ARGS__)
 
 #endif // !GOL_LOG_HPP
@@ -0,0 +1,143 @@
+#include "log_message.hpp"
+
+#include <spdlog/fmt/fmt.h>
+
+#if FMT_VERSION >= 80000
+#include <fmt/args.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace logging {
+
+auto parse_level(std::string_view const name) noexcept -> std::optional<level>
+{
+    constexpr std::array<std::string_view, 6> names = { "trace", "info", "warn", "error", "fatal", "off" };
+    static_assert(names.size() == static_cast<std::size_t>(level::off) + 1, "Every level needs a name");
+
+    auto const it = std::find(names.begin(), names.end(), name);
+
+    if(it == names.end()) {
+        return std::nullopt;
+    }
+
+    return static_cast<level>(it - names.begin());
+}
+
+auto append_text(message& m, argument& a, std::string_view const text) noexcept -> void
+{
+    auto const length = std::min(text.size(), message::s_text_size - m.text_used);
+
+    a.type = argument::kind::text;
+    a.offset = m.text_used;
+    a.length = static_cast<std::uint16_t>(length);
+
+    std::memcpy(m.text.data() + m.text_used, text.data(), length); // NOLINT
+    m.text_used = static_cast<std::uint16_t>(m.text_used + length);
+}
+
+auto to_text(message const& m) -> std::string
+{
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+
+    for(std::size_t i = 0; i < m.count; ++i) {
+        auto const& a = m.args[i]; // NOLINT
+
+        switch(a.type) {
+        case argument::kind::signed_integer:
+            store.push_back(a.value.i); // NOLINT
+            break;
+        case argument::kind::unsigned_integer:
+            store.push_back(a.value.u); // NOLINT
+            break;
+        case argument::kind::floating_point:
+            store.push_back(a.value.d); // NOLINT
+            break;
+        case argument::kind::boolean:
+            store.push_back(a.value.b); // NOLINT
+            break;
+        case argument::kind::text:
+            store.push_back(std::string{ m.text.data() + a.offset, a.length }); // NOLINT
+            break;
+        }
+    }
+
+    try {
+        return fmt::vformat(m.format, store);
+    }
+    catch(fmt::format_error const& e) {
+        return std::string{ m.format } + " (" + e.what() + ")";
+    }
+}
+
+auto recorder::local_buffer() -> buffer&
+{
+    struct cached
+    {
+        std::uint64_t owner = std::numeric_limits<std::uint64_t>::max();
+        buffer* buf = nullptr;
+    };
+
+    thread_local cached local;
+
+    if(local.owner == m_id) {
+        return *local.buf;
+    }
+
+    std::lock_guard<std::mutex> const lock{ m_mutex };
+    auto const id = std::this_thread::get_id();
+    auto it = std::find_if(m_buffers.begin(), m_buffers.end(), [id](auto const& b) { return b.first == id; });
+
+    if(it == m_buffers.end()) {
+        m_buffers.emplace_back(id, std::make_unique<buffer>());
+        it = std::prev(m_buffers.end());
+    }
+
+    local = { m_id, it->second.get() };
+    return *local.buf;
+}
+
+auto recorder::push(message const& m) noexcept -> bool
+{
+    try {
+        if(this->local_buffer().try_push(m)) {
+            return true;
+        }
+    }
+    catch(...) {
+        // no memory for the thread's ring, the message goes the same way as one that didn't fit
+    }
+
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+auto recorder::drain(std::vector<message>& out) -> std::size_t
+{
+    m_draining.clear();
+    {
+        std::lock_guard<std::mutex> const lock{ m_mutex };
+        for(auto const& b : m_buffers) {
+            m_draining.push_back(b.second.get());
+        }
+    }
+
+    auto const first = static_cast<std::ptrdiff_t>(out.size());
+    message m;
+
+    for(auto* buf : m_draining) {
+        while(buf->try_pop(m)) {
+            out.push_back(m);
+        }
+    }
+
+    // every buffer is in order, interleave the threads
+    std::stable_sort(
+        out.begin() + first, out.end(), [](message const& a, message const& b) { return a.time < b.time; });
+
+    return m_dropped.exchange(0, std::memory_order_relaxed);
+}
+
+} // namespace logging
@@ -0,0 +1,159 @@
+#ifndef GOL_LOG_MESSAGE_HPP
+#define GOL_LOG_MESSAGE_HPP
+#pragma once
+
+#include "thread/ring_buffer.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace logging {
+
+enum class level : std::uint8_t
+{
+    trace,
+    info,
+    warn,
+    error,
+    fatal,
+    off
+};
+
+// trace, info, warn, error, fatal or off
+[[nodiscard]] auto parse_level(std::string_view name) noexcept -> std::optional<level>;
+
+// An argument as it was passed, only turned into text on the logging thread
+struct argument
+{
+    enum class kind : std::uint8_t
+    {
+        signed_integer,
+        unsigned_integer,
+        floating_point,
+        boolean,
+        text
+    };
+
+    kind type = kind::signed_integer;
+    // for text, where the characters were copied to in the message's text
+    std::uint16_t offset = 0;
+    std::uint16_t length = 0;
+
+    union
+    {
+        std::int64_t i;
+        std::uint64_t u;
+        double d;
+        bool b;
+    } value{}; // NOLINT
+};
+
+struct message
+{
+    static constexpr std::size_t s_max_args = 6;
+    static constexpr std::size_t s_text_size = 256;
+
+    // the format string literal, its address is the id of the call site
+    char const* format = nullptr;
+    level severity = level::info;
+    std::uint8_t count = 0;
+    std::uint16_t text_used = 0;
+    std::chrono::system_clock::time_point time{};
+    std::array<argument, s_max_args> args{};
+    // the characters of every text argument, longer ones are cut. Only the first text_used are meaningful.
+    std::array<char, s_text_size> text; // NOLINT
+};
+
+auto append_text(message& m, argument& a, std::string_view text) noexcept -> void;
+
+template<typename T>
+auto append(message& m, T const& value) noexcept -> void
+{
+    auto& a = m.args[m.count++]; // NOLINT
+
+    if constexpr(std::is_same_v<T, bool>) {
+        a.type = argument::kind::boolean;
+        a.value.b = value; // NOLINT
+    }
+    else if constexpr(std::is_same_v<T, char>) {
+        append_text(m, a, std::string_view{ &value, 1 });
+    }
+    else if constexpr(std::is_enum_v<T>) {
+        a.type = argument::kind::signed_integer;
+        a.value.i = static_cast<std::int64_t>(value); // NOLINT
+    }
+    else if constexpr(std::is_integral_v<T> && std::is_signed_v<T>) {
+        a.type = argument::kind::signed_integer;
+        a.value.i = value; // NOLINT
+    }
+    else if constexpr(std::is_integral_v<T>) {
+        a.type = argument::kind::unsigned_integer;
+        a.value.u = value; // NOLINT
+    }
+    else if constexpr(std::is_floating_point_v<T>) {
+        a.type = argument::kind::floating_point;
+        a.value.d = static_cast<double>(value); // NOLINT
+    }
+    else {
+        static_assert(std::is_convertible_v<T const&, std::string_view>, "Log arguments are numbers or text");
+        append_text(m, a, std::string_view{ value });
+    }
+}
+
+// the format string filled in with the arguments, a bad format string comes out as is with the error after it
+[[nodiscard]] auto to_text(message const& m) -> std::string;
+
+// Every thread's messages in a lock-free ring of its own, merged into a single stream in time order by drain(). Any
+// number of threads push, one at a time drains.
+class recorder
+{
+private:
+    static constexpr std::size_t s_buffer_size = 512;
+
+    // only ever pushed to by its thread, or by a later thread that got the same id once it ended
+    using buffer = gol::ring_buffer<message, s_buffer_size>;
+
+    // tells recorders apart in the threads' cached buffers, where an address could be reused
+    static inline std::atomic<std::uint64_t> s_next_id{ 0 };
+
+    std::uint64_t m_id = s_next_id.fetch_add(1, std::memory_order_relaxed);
+    std::atomic<std::size_t> m_dropped{ 0 };
+    // only guards registering new per-thread buffers, recording never takes it
+    std::mutex m_mutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<buffer>>> m_buffers;
+    std::vector<buffer*> m_draining;
+
+    [[nodiscard]] auto local_buffer() -> buffer&;
+
+public:
+    recorder() = default;
+    recorder(recorder const&) = delete;
+    recorder(recorder&&) noexcept = delete;
+    ~recorder() noexcept = default;
+
+    auto operator=(recorder const&) -> recorder& = delete;
+    auto operator=(recorder&&) noexcept -> recorder& = delete;
+
+    // false if `m` was dropped, the calling thread's ring being full or impossible to allocate
+    auto push(message const& m) noexcept -> bool;
+
+    // Appends every message recorded since the last call to `out`, ordered by time and then by thread. Returns how
+    // many were dropped since the last call.
+    auto drain(std::vector<message>& out) -> std::size_t;
+};
+
+} // namespace logging
+
+#endif // !GOL_LOG_MESSAGE_HPP
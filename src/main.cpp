@@ -1,23 +1,58 @@
 #include "gol_scene.hpp"
 #include "log.hpp"
+#include "memory.hpp"
+#include "metrics_server.hpp"
 #include "preview_scene.hpp"
+#include "profiler.hpp"
+#include "render_bench.hpp"
 #include "sdl.hpp"
+#include "service.hpp"
 #include "view.hpp"
 
+#include "engine/engine.hpp"
+#include "engine/pattern.hpp"
+#include "engine/rule.hpp"
+#include "engine/validate.hpp"
+#include "thread/metrics.hpp"
+#include "thread/trace.hpp"
+
 #include <docopt/docopt.h>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 std::map<std::string, gol::color> const g_colors = {
     { "white", { 1.0F, 1.0F, 1.0F } }, { "black", { 0.0F, 0.0F, 0.0F } },   { "red", { 1.0F, 0.0F, 0.0F } },
     { "blue", { 0.0F, 0.0F, 1.0F } },  { "yellow", { 1.0F, 0.96F, 0.0F } }, { "green", { 0.0F, 1.0F, 0.0F } }
 };
 
+gol::metric g_population{ "gol_population", "Alive cells on the whole board", gol::metric_kind::gauge };
+gol::metric g_frame_time_p50{ "gol_frame_time_p50_seconds",
+                              "Median time of the last drawn frames",
+                              gol::metric_kind::gauge,
+                              1e-9 };
+gol::metric g_frame_time_p99{ "gol_frame_time_p99_seconds",
+                              "99th percentile time of the last drawn frames",
+                              gol::metric_kind::gauge,
+                              1e-9 };
+gol::metric g_memory{ "gol_memory_bytes", "Bytes held by the big CPU and GPU buffers", gol::metric_kind::gauge };
+
 std::string const g_usage = R"(GameOfLife
 
 Usage:
@@ -25,6 +60,30 @@ Usage:
                     [(--width=<grid_width> --height=<grid_height>)]
                     [--color-dead=<color_dead>]
                     [--color-alive=<color_alive>]
+                    [--census-every=<generations>]
+                    [--profile]
+                    [--profile-csv=<file>]
+                    [--trace=<file>]
+                    [--engine=<name>]
+                    [--threads=<n>]
+                    [--pin-threads]
+                    [--rule=<rule>]
+                    [--topology=<topology>]
+                    [--validate-every=<generations>]
+                    [--generations-per-second=<n>]
+                    [--pattern=<file>]
+                    [--density=<d>]
+                    [--seed=<seed>]
+                    [--record=<file> | --replay=<file>]
+                    [--fixed-timestep=<ms>]
+                    [--max-memory=<MB>]
+                    [--log-level=<level>]
+                    [--metrics=<address>]
+    GameOfLife --validate [--seed=<seed>]
+    GameOfLife --render-bench [--frames=<n>] [(--width=<grid_width> --height=<grid_height>)] [--engine=<name>]
+                    [--threads=<n>]
+    GameOfLife --serve=<address> [--threads=<n>] [--rule=<rule>] [--topology=<topology>] [--metrics=<address>]
+                    [--max-memory=<MB>] [--log-level=<level>]
 
 Options:
     -h --help                       Show this screen.
@@ -32,6 +91,38 @@ Options:
     --height=<grid_height>          How many cells vertically [default: 50].
     --color-dead=<color_dead>       What color should a dead cell have [default: black].
     --color-alive=<color_alive>     What color should an alive cell have [default: white].
+    --census-every=<generations>    Print an object census every N generations, 0 for only on 'c' [default: 0].
+    --profile                       Show p50/p99 timings of every frame phase in the window title.
+    --profile-csv=<file>            Write the time spent in every frame phase to a CSV file, one row per frame.
+    --trace=<file>                  Write a chrome trace (JSON) of the simulation and render timelines.
+    --engine=<name>                 Simulation engine: scalar, sliding or parallel [default: sliding].
+    --threads=<n>                   Threads used by the parallel engine, 0 for all cores [default: 0].
+    --pin-threads                   Pin every thread of the parallel engine to its own core.
+    --rule=<rule>                   Life-like rule in B/S notation [default: B3/S23].
+    --topology=<topology>           What's past the edges of the grid: bounded or torus [default: bounded].
+    --validate-every=<generations>  Check every Nth generation against the reference engine, 0 to never [default: 0].
+    --generations-per-second=<n>    How fast the simulation runs, 0 for as fast as possible [default: 60].
+    --record=<file>                 Write every input event to a file with the frame and time it happened at.
+    --replay=<file>                 Feed the input recorded with --record instead of the keyboard and mouse, then print
+                                    frame times and exit.
+    --fixed-timestep=<ms>           Advance the scenes by this much every frame instead of the time it took, 0 to
+                                    measure it. With --replay the simulation steps as many generations as that
+                                    much time holds every frame too [default: 0].
+    --max-memory=<MB>               Refuse to start if the expected memory use is above this, with --serve refuse
+                                    new sessions past it instead, 0 for no limit [default: 0].
+    --log-level=<level>             Lowest level logged: trace, info, warn, error, fatal or off. Debug builds start at
+                                    trace, the others at info.
+    --metrics=<address>             Serve Prometheus metrics at /metrics on a port of 127.0.0.1 or a Unix domain
+                                    socket path.
+    --validate                      Check every engine against the reference on random boards, rules and topologies.
+    --pattern=<file>                Pattern pasted at the cursor with 'p' while editing, plaintext or RLE.
+    --density=<d>                   Share of the cells 'r' fills at random while editing [default: 0.3].
+    --seed=<seed>                   Seed of the random boards of --validate and of 'r' [default: 1].
+    --render-bench                  Render a random board in a hidden window and print upload and draw times.
+    --frames=<n>                    Frames rendered by --render-bench for each camera position [default: 300].
+    --serve=<address>               Host simulations for other processes on a port of 127.0.0.1 or a Unix domain
+                                    socket path, without a window. --rule and --topology are the defaults of new
+                                    sessions, --threads steps them.
 )";
 
 auto configure(std::map<std::string, docopt::value>& args, int& num_cells_w, int& num_cells_h) -> void
@@ -58,48 +149,373 @@ auto configure_view(std::map<std::string, docopt::value>& args, gol::color& aliv
     }
 }
 
+// Runs every engine against the reference engine, writes the smallest board each failing engine diverges on
+auto validate_engines(std::uint64_t const seed) -> int
+{
+    constexpr int trials = 200;
+    constexpr int generations = 32;
+
+    int result = 0;
+
+    for(auto const& name : gol::available_engines()) {
+        auto e = gol::make_engine(name, std::max(1U, std::thread::hardware_concurrency()));
+        auto const d = gol::validate_random(*e, seed, trials, generations);
+
+        if(!d.has_value()) {
+            std::cout << name << ": ok (seed " << seed << ", " << trials << " boards)\n";
+            continue;
+        }
+
+        auto const path = "divergence-" + name + ".cells";
+        std::ofstream out{ path };
+        gol::write_divergence(out, *d);
+
+        std::cout << name << ": diverged at generation " << d->generation << " (seed " << seed << "), " << path
+                  << ":\n";
+        gol::write_divergence(std::cout, *d);
+        result = 1;
+    }
+
+    return result;
+}
+
+// SIGUSR1 asks for the same report as 'm'
+extern "C" auto on_memory_signal([[maybe_unused]] int signal) -> void
+{
+    gol::request_memory_report();
+}
+
+// SIGINT and SIGTERM stop --serve cleanly
+extern "C" auto on_stop_signal([[maybe_unused]] int signal) -> void
+{
+    gol::service::request_stop();
+}
+
+// runs until a client sends `shutdown` or the process is interrupted
+auto serve(std::map<std::string, docopt::value>& args, gol::engine const& defaults) -> int
+{
+    std::size_t num_threads = std::stoul(args["--threads"].asString());
+    if(num_threads == 0) {
+        num_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    gol::metrics_server metrics;
+    if(args["--metrics"].isString() && !metrics.start(args["--metrics"].asString())) {
+        ERROR("Could not serve metrics on {}", args["--metrics"].asString());
+    }
+
+    std::signal(SIGINT, on_stop_signal);
+    std::signal(SIGTERM, on_stop_signal);
+
+    constexpr std::size_t bytes_per_mb = 1024 * 1024;
+    auto const max_memory = std::stoull(args["--max-memory"].asString()) * bytes_per_mb;
+
+    gol::service s{ defaults.rule(), defaults.topology(), num_threads, max_memory };
+
+    if(!s.run(args["--serve"].asString())) {
+        std::cerr << "Could not listen on " << args["--serve"].asString() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+
+// what only the main thread can read, the simulation updates its own metrics
+auto update_metrics(gol::view const& view, gol::scene const& scene) -> void
+{
+    constexpr double ms_to_ns = 1e6;
+    constexpr double p50 = 0.5;
+    constexpr double p99 = 0.99;
+
+    auto const& profiler = gol::profiler::get();
+    gol::memory_report report;
+    view.report_memory(report);
+    scene.report_memory(report);
+
+    g_population.set(static_cast<std::int64_t>(view.population()));
+    g_frame_time_p50.set(static_cast<std::int64_t>(profiler.percentile(gol::phase::frame, p50) * ms_to_ns));
+    g_frame_time_p99.set(static_cast<std::int64_t>(profiler.percentile(gol::phase::frame, p99) * ms_to_ns));
+    g_memory.set(static_cast<std::int64_t>(report.total()));
+}
+
+auto print_frame_times(std::vector<double> const& frame_ms) -> void
+{
+    if(frame_ms.empty()) {
+        return;
+    }
+
+    constexpr double p50 = 0.5;
+    constexpr double p99 = 0.99;
+
+    std::cout << frame_ms.size() << " frames drawn, frame time p50/p99/max " << gol::percentile(frame_ms, p50) << '/'
+              << gol::percentile(frame_ms, p99) << '/' << gol::percentile(frame_ms, 1.0) << " ms\n";
+}
+
+// nullptr if the engine, rule or topology is invalid
+auto configure_engine(std::map<std::string, docopt::value>& args) -> std::unique_ptr<gol::engine>
+{
+    std::size_t num_threads = std::stoul(args["--threads"].asString());
+    if(num_threads == 0) {
+        num_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    bool const pin_threads = args["--pin-threads"].isBool() && args["--pin-threads"].asBool();
+
+    auto e = gol::make_engine(args["--engine"].asString(), num_threads, pin_threads);
+    if(e == nullptr) {
+        std::cerr << "Unknown engine: " << args["--engine"].asString() << '\n';
+        return nullptr;
+    }
+
+    auto const r = gol::parse_rule(args["--rule"].asString());
+    if(!r.has_value()) {
+        std::cerr << "Invalid rule: " << args["--rule"].asString() << '\n';
+        return nullptr;
+    }
+
+    auto const t = gol::parse_topology(args["--topology"].asString());
+    if(!t.has_value()) {
+        std::cerr << "Unknown topology: " << args["--topology"].asString() << '\n';
+        return nullptr;
+    }
+
+    e->set_rule(*r);
+    e->set_topology(*t);
+
+    return e;
+}
+
 auto main(int argc, char* argv[]) noexcept -> int
 {
     [[maybe_unused]] auto args = docopt::docopt(g_usage, { argv + 1, argv + argc }, /*show help:*/ true, "GameOfLife");
 
+    if(args["--log-level"].isString()) {
+        auto const l = logging::parse_level(args["--log-level"].asString());
+        if(!l.has_value()) {
+            std::cerr << "Unknown log level: " << args["--log-level"].asString() << '\n';
+            return 1;
+        }
+
+        logging::logger::set_level(*l);
+    }
+
+    if(args["--validate"].isBool() && args["--validate"].asBool()) {
+        return validate_engines(std::stoull(args["--seed"].asString()));
+    }
+
     constexpr int default_num_cells = 50;
     int num_cells_w = default_num_cells;
     int num_cells_h = default_num_cells;
 
     configure(args, num_cells_w, num_cells_h);
 
+    auto engine = configure_engine(args);
+    if(engine == nullptr) {
+        return 1;
+    }
+
+    if(args["--serve"].isString()) {
+        return serve(args, *engine);
+    }
+
+    if(args["--render-bench"].isBool() && args["--render-bench"].asBool()) {
+        constexpr int viewport_width = 1280;
+        constexpr int viewport_height = 720;
+
+        auto const frames = std::stoi(args["--frames"].asString());
+        if(frames <= 0) {
+            std::cerr << "--frames must be at least 1\n";
+            return 1;
+        }
+
+        gol::render_bench_config const config = { num_cells_w, num_cells_h, frames, viewport_width, viewport_height };
+
+        return gol::run_render_bench(config, *engine, std::cout);
+    }
+
+    std::optional<gol::bit_grid> pattern;
+    if(args["--pattern"].isString()) {
+        pattern = gol::load_pattern(args["--pattern"].asString());
+
+        if(!pattern.has_value()) {
+            std::cerr << "Could not read a pattern from " << args["--pattern"].asString() << '\n';
+            return 1;
+        }
+    }
+
     gol::color alive_color;
     gol::color dead_color;
 
     configure_view(args, alive_color, dead_color);
 
+    int validate_every = 0;
+    if(args["--validate-every"].isString()) {
+        validate_every = std::stoi(args["--validate-every"].asString());
+    }
+
+    {
+        gol::memory_report expected;
+        gol::view::estimate_memory(num_cells_w, num_cells_h, expected);
+        gol::gol_scene::estimate_memory(num_cells_w, num_cells_h, validate_every > 0, expected);
+
+        std::cout << "Expected memory use of a " << num_cells_w << 'x' << num_cells_h << " board:\n";
+        expected.print(std::cout);
+
+        constexpr std::size_t bytes_per_mb = 1024 * 1024;
+        auto const max_memory = std::stoull(args["--max-memory"].asString()) * bytes_per_mb;
+
+        if(max_memory > 0 && expected.total() > max_memory) {
+            std::cerr << "Expected memory use is above --max-memory=" << args["--max-memory"].asString() << " MB\n";
+            return 1;
+        }
+    }
+
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, on_memory_signal);
+#endif
+
     sdl::window window{ "GameOfLife" };
-    gol::view view{ num_cells_w, num_cells_h, alive_color, dead_color };
+
+    if(args["--record"].isString() && !window.record(args["--record"].asString())) {
+        std::cerr << "Could not open " << args["--record"].asString() << " for writing\n";
+        return 1;
+    }
+    if(args["--replay"].isString() && !window.replay(args["--replay"].asString())) {
+        std::cerr << "Could not read a recording from " << args["--replay"].asString() << '\n';
+        return 1;
+    }
+
+    std::optional<gol::view> board_view;
+    try {
+        board_view.emplace(num_cells_w, num_cells_h, alive_color, dead_color);
+    }
+    catch(std::length_error const& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    auto& view = *board_view;
+    view.set_viewport(window.width(), window.height());
 
     gol::coord const pos = { num_cells_w / 2, num_cells_h / 2 };
     view.set_alive(pos);
 
     std::queue<std::unique_ptr<gol::scene>> scene;
 
-    scene.push(std::make_unique<gol::preview_scene>());
-    scene.push(std::make_unique<gol::gol_scene>());
+    scene.push(std::make_unique<gol::preview_scene>(
+        std::move(pattern), std::stod(args["--density"].asString()), std::stoull(args["--seed"].asString())));
+    int census_every = 0;
+    if(args["--census-every"].isString()) {
+        census_every = std::stoi(args["--census-every"].asString());
+    }
+
+    int generations_per_second = 0;
+    if(args["--generations-per-second"].isString()) {
+        generations_per_second = std::stoi(args["--generations-per-second"].asString());
+    }
+
+    float const fixed_timestep = std::stof(args["--fixed-timestep"].asString()) / 1000.0F;
+
+    auto game =
+        std::make_unique<gol::gol_scene>(std::move(engine), census_every, validate_every, generations_per_second);
+    // a replay with a fixed timestep is only repeatable if the simulation keeps time with the frames too
+    if(window.replaying() && fixed_timestep > 0.0F) {
+        auto const per_frame = std::lround(static_cast<float>(generations_per_second) * fixed_timestep);
+        game->step_per_frame(std::max(1, static_cast<int>(per_frame)));
+    }
+    scene.push(std::move(game));
 
     scene.front()->setup_event_handling(window, view);
 
+    auto& profiler = gol::profiler::get();
+    bool const show_profile = args["--profile"].isBool() && args["--profile"].asBool();
+
+    if(args["--profile-csv"].isString() && !profiler.open_csv(args["--profile-csv"].asString())) {
+        ERROR("Could not open {} for writing", args["--profile-csv"].asString());
+    }
+
+    if(args["--trace"].isString() && !gol::tracer::get().start(args["--trace"].asString())) {
+        ERROR("Could not open {} for writing", args["--trace"].asString());
+    }
+
+    gol::metrics_server metrics;
+    if(args["--metrics"].isString() && !metrics.start(args["--metrics"].asString())) {
+        ERROR("Could not serve metrics on {}", args["--metrics"].asString());
+    }
+
     using namespace std::chrono;
+    std::vector<double> frame_ms;
     float elapsed = 0.0F;
     auto start = steady_clock::now();
-    constexpr float to_seconds = 1000.0F;
+    auto last_stats_update = start;
+    // how often the profile in the title and the main thread's metrics are refreshed
+    constexpr auto stats_update_interval = milliseconds{ 500 };
+    // longest an idle frame blocks on input, the simulation wakes it up as soon as a generation changes something
+    constexpr int idle_wait_ms = 250;
+    bool drawn = true;
 
     while(!window.should_close()) {
         auto end = steady_clock::now();
-        elapsed = static_cast<float>(duration_cast<milliseconds>(end - start).count()) / to_seconds;
+
+        // frames that drew nothing are no measure of how far the scenes should move things
+        if(fixed_timestep > 0.0F) {
+            elapsed = fixed_timestep;
+        }
+        else if(drawn) {
+            elapsed = duration<float>(end - start).count();
+        }
         start = end;
 
-        window.handle_events();
+        if(drawn) {
+            gol::scoped_timer const timer{ gol::phase::events };
+            window.handle_events();
+        }
+        else {
+            // nothing changed last frame, sleep until something happens instead of spinning
+            window.handle_events(idle_wait_ms);
+            start = steady_clock::now();
+        }
+
+        if(window.take_exposed()) {
+            view.invalidate();
+        }
+
         scene.front()->update(elapsed);
-        view.update();
-        window.swap_buffers();
+
+        {
+            gol::scoped_timer const timer{ gol::phase::draw };
+            drawn = view.update();
+        }
+        if(drawn) {
+            gol::scoped_timer const timer{ gol::phase::swap };
+            window.swap_buffers();
+        }
+
+        if(drawn) {
+            profiler.record(gol::phase::frame, steady_clock::now() - end);
+        }
+        profiler.end_frame();
+
+        if(window.replaying() && drawn) {
+            frame_ms.push_back(duration<double, std::milli>(steady_clock::now() - end).count());
+        }
+
+        if(gol::take_memory_report_request()) {
+            gol::memory_report report;
+            view.report_memory(report);
+            scene.front()->report_memory(report);
+            report.print(std::cout);
+        }
+
+        if(end - last_stats_update >= stats_update_interval) {
+            if(show_profile) {
+                window.set_title("GameOfLife | " + profiler.summary());
+            }
+            if(metrics.running()) {
+                update_metrics(view, *scene.front());
+            }
+            last_stats_update = end;
+        }
 
         if(scene.front()->finished()) {
             scene.pop();
@@ -111,4 +527,9 @@ auto main(int argc, char* argv[]) noexcept -> int
             scene.front()->setup_event_handling(window, view);
         }
     }
+
+    if(window.replaying()) {
+        print_frame_times(frame_ms);
+        std::cout << profiler.summary() << '\n';
+    }
 }
@@ -0,0 +1,82 @@
+#include "memory.hpp"
+
+#include <atomic>
+#include <iomanip>
+#include <utility>
+
+namespace {
+
+std::atomic<bool> g_report_requested{ false };
+
+static_assert(std::atomic<bool>::is_always_lock_free, "signal handlers may only touch lock-free atomics");
+
+[[nodiscard]] auto to_mb(std::size_t const bytes) -> double
+{
+    constexpr double bytes_per_mb = 1024.0 * 1024.0;
+    return static_cast<double>(bytes) / bytes_per_mb;
+}
+
+} // namespace
+
+namespace gol {
+
+auto memory_report::add(std::string subsystem, std::string buffer, std::size_t const bytes) -> void
+{
+    m_entries.push_back({ std::move(subsystem), std::move(buffer), bytes });
+}
+
+auto memory_report::total() const noexcept -> std::size_t
+{
+    std::size_t bytes = 0;
+
+    for(auto const& e : m_entries) {
+        bytes += e.bytes;
+    }
+
+    return bytes;
+}
+
+auto memory_report::print(std::ostream& out) const -> void
+{
+    constexpr int name_width = 36;
+    constexpr int size_width = 10;
+
+    auto const flags = out.flags();
+    auto const precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+
+    // entries of a subsystem are added one after the other
+    for(std::size_t i = 0; i < m_entries.size();) {
+        auto const& subsystem = m_entries[i].subsystem;
+        std::size_t subtotal = 0;
+
+        out << subsystem << ":\n";
+
+        for(; i < m_entries.size() && m_entries[i].subsystem == subsystem; ++i) {
+            out << "    " << std::left << std::setw(name_width) << m_entries[i].buffer << std::right
+                << std::setw(size_width) << to_mb(m_entries[i].bytes) << " MB\n";
+            subtotal += m_entries[i].bytes;
+        }
+
+        out << "    " << std::left << std::setw(name_width) << "total" << std::right << std::setw(size_width)
+            << to_mb(subtotal) << " MB\n";
+    }
+
+    out << std::left << std::setw(name_width + 4) << "Total" << std::right << std::setw(size_width)
+        << to_mb(this->total()) << " MB\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+auto request_memory_report() noexcept -> void
+{
+    g_report_requested.store(true, std::memory_order_relaxed);
+}
+
+auto take_memory_report_request() noexcept -> bool
+{
+    return g_report_requested.exchange(false, std::memory_order_relaxed);
+}
+
+} // namespace gol
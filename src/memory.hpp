@@ -0,0 +1,41 @@
+#ifndef GOL_MEMORY_HPP
+#define GOL_MEMORY_HPP
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace gol {
+
+// The big buffers of every part of the program and how many bytes they hold, filled in by whoever owns them
+class memory_report
+{
+private:
+    struct entry
+    {
+        std::string subsystem;
+        std::string buffer;
+        std::size_t bytes = 0;
+    };
+
+    std::vector<entry> m_entries;
+
+public:
+    auto add(std::string subsystem, std::string buffer, std::size_t bytes) -> void;
+
+    [[nodiscard]] auto total() const noexcept -> std::size_t;
+    // a line per buffer in MB, then a total per subsystem and one for everything
+    auto print(std::ostream& out) const -> void;
+};
+
+// Asks the main loop to print what's allocated right now. Only touches a lock-free atomic, so it's safe to call from
+// a signal handler.
+auto request_memory_report() noexcept -> void;
+// true once for every batch of requests
+[[nodiscard]] auto take_memory_report_request() noexcept -> bool;
+
+} // namespace gol
+
+#endif // !GOL_MEMORY_HPP
@@ -0,0 +1,87 @@
+#include "metrics_server.hpp"
+
+#include "thread/metrics.hpp"
+
+#include <array>
+#include <sstream>
+
+namespace gol {
+
+metrics_server::~metrics_server() noexcept
+{
+    m_stop.store(true, std::memory_order_release);
+
+    if(m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+auto metrics_server::start(std::string const& address) -> bool
+{
+    if(m_thread.joinable()) {
+        return false;
+    }
+
+    m_listener = gol::listen_local(address);
+
+    if(!m_listener.valid()) {
+        return false;
+    }
+
+    m_thread = std::thread{ [this] {
+        while(!m_stop.load(std::memory_order_acquire)) {
+            auto const client = m_listener.accept(s_poll_interval_ms);
+
+            if(client.valid()) {
+                this->serve(client);
+            }
+        }
+
+        m_listener.close();
+    } };
+
+    return true;
+}
+
+auto metrics_server::running() const noexcept -> bool
+{
+    return m_thread.joinable();
+}
+
+auto metrics_server::serve(gol::socket const& client) -> void
+{
+    constexpr std::size_t max_request_size = 4096;
+
+    client.set_receive_timeout(s_receive_timeout_ms);
+
+    // only the request line matters, the headers are read so the client isn't cut off mid request
+    std::string request;
+    std::array<char, 512> chunk{};
+
+    while(request.find("\r\n\r\n") == std::string::npos && request.size() < max_request_size) {
+        auto const received = client.receive(chunk.data(), chunk.size());
+        if(received == 0) {
+            break;
+        }
+
+        request.append(chunk.data(), received);
+    }
+
+    if(request.rfind("GET /metrics ", 0) != 0 && request.rfind("GET /metrics?", 0) != 0) {
+        client.send("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+        return;
+    }
+
+    std::ostringstream body;
+    gol::metrics::get().write(body);
+    auto const text = body.str();
+
+    std::ostringstream response;
+    response << "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " << text.size()
+             << "\r\nConnection: close\r\n\r\n"
+             << text;
+
+    client.send(response.str());
+}
+
+} // namespace gol
@@ -0,0 +1,43 @@
+#ifndef GOL_METRICS_SERVER_HPP
+#define GOL_METRICS_SERVER_HPP
+#pragma once
+
+#include "socket.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace gol {
+
+// Answers HTTP GETs of /metrics on a local socket with everything in gol::metrics, in the Prometheus text format.
+// Clients are served one at a time on the server's own thread, a scrape sums the per-thread counters right then.
+class metrics_server
+{
+private:
+    static constexpr int s_poll_interval_ms = 100;
+    static constexpr int s_receive_timeout_ms = 1000;
+
+    gol::socket m_listener;
+    std::atomic<bool> m_stop{ false };
+    std::thread m_thread;
+
+    auto serve(gol::socket const& client) -> void;
+
+public:
+    metrics_server() noexcept = default;
+    metrics_server(metrics_server const&) = delete;
+    metrics_server(metrics_server&&) noexcept = delete;
+    ~metrics_server() noexcept;
+
+    auto operator=(metrics_server const&) -> metrics_server& = delete;
+    auto operator=(metrics_server&&) noexcept -> metrics_server& = delete;
+
+    // `address` is a port on 127.0.0.1 or a Unix domain socket path, false if it can't be listened on
+    auto start(std::string const& address) -> bool;
+    [[nodiscard]] auto running() const noexcept -> bool;
+};
+
+} // namespace gol
+
+#endif // !GOL_METRICS_SERVER_HPP
@@ -1,8 +1,11 @@
 #include "preview_scene.hpp"
 
 #include "assert.hpp"
+#include "profiler.hpp"
 
+#include <algorithm>
 #include <string>
+#include <utility>
 
 namespace {
 
@@ -23,6 +26,16 @@ namespace {
         return "S";
     case sdl::key_event::vk_space:
         return "SPACE";
+    case sdl::key_event::vk_f:
+        return "F";
+    case sdl::key_event::vk_x:
+        return "X";
+    case sdl::key_event::vk_r:
+        return "R";
+    case sdl::key_event::vk_p:
+        return "P";
+    case sdl::key_event::vk_m:
+        return "M";
     case sdl::key_event::vk_escape:
         return "ESCAPE";
     default:
@@ -33,33 +46,30 @@ namespace {
 [[nodiscard]] auto screen_to_grid(sdl::window& window, gol::view& view, sdl::mouse_coord_t const c) noexcept
     -> gol::coord
 {
-    float const x = (2.0F * static_cast<float>(c.first)) / static_cast<float>(window.width()) - 1.0F;
-    float const y = -((2.0F * static_cast<float>(c.second)) / static_cast<float>(window.height()) - 1.0F);
-    float const z = 1.0F;
-    glm::vec3 ray_nds{ x, y, z };
-    glm::vec4 const ray_clip = glm::vec4{ ray_nds.x, ray_nds.y, -1.0F, 1.0F }; // NOLINT
-    glm::vec4 ray_eye = glm::inverse(view.projection_matrix()) * ray_clip;
-    ray_eye = glm::vec4(ray_eye.x, ray_eye.y, -1.0F, 0.0F); // NOLINT
-    glm::vec3 ray_wor = glm::inverse(view.view_matrix()) * ray_eye;
-    // ray_wor = glm::normalize(ray_wor);
-    TRACE("wx={}, wy={}", ray_wor.x, ray_wor.y); // NOLINT
-
-    float const grid_width = static_cast<float>(view.width()) * gol::view::cell_dimension();
-    float const grid_height = static_cast<float>(view.height()) * gol::view::cell_dimension();
-
-    float const absx = ray_wor.x + grid_width / 2.0F;                                          // NOLINT
-    float const absy = std::abs(ray_wor.y - grid_height / 2.0F - gol::view::cell_dimension()); // NOLINT
-
-    auto const grid_x = static_cast<int>(absx / gol::view::cell_dimension());
-    auto const grid_y = static_cast<int>(absy / gol::view::cell_dimension());
-
-    return { grid_x, grid_y };
+    return view.screen_to_grid(c.first, c.second, window.width(), window.height());
 }
 
 } // namespace
 
 namespace gol {
 
+preview_scene::preview_scene(std::optional<bit_grid> pattern, double const density, std::uint64_t const seed)
+    : m_pattern{ std::move(pattern) }
+    , m_density{ density }
+    , m_rng{ seed }
+{
+}
+
+auto preview_scene::cell_under_mouse() const noexcept -> gol::coord
+{
+    return screen_to_grid(*m_window, *m_view, m_window->get_mouse_coord());
+}
+
+auto preview_scene::has_selection() const noexcept -> bool
+{
+    return m_selection_end.x >= 0;
+}
+
 auto preview_scene::setup_event_handling(sdl::window& window, gol::view& view) noexcept -> void
 {
     m_window = &window;
@@ -100,6 +110,29 @@ auto preview_scene::setup_event_handling(sdl::window& window, gol::view& view) n
             m_finished = true;
             break;
         }
+        case sdl::key_event::vk_f:
+        case sdl::key_event::vk_x: {
+            if(this->has_selection()) {
+                view.fill(m_selection_start, m_selection_end, ev == sdl::key_event::vk_f);
+            }
+            break;
+        }
+        case sdl::key_event::vk_r: {
+            if(this->has_selection()) {
+                view.randomize(m_selection_start, m_selection_end, m_density, m_rng);
+            }
+            break;
+        }
+        case sdl::key_event::vk_p: {
+            if(m_pattern.has_value()) {
+                view.paste(*m_pattern, this->cell_under_mouse());
+            }
+            break;
+        }
+        case sdl::key_event::vk_m: {
+            gol::request_memory_report();
+            break;
+        }
         default: {
             break;
         }
@@ -117,6 +150,17 @@ auto preview_scene::setup_event_handling(sdl::window& window, gol::view& view) n
         TRACE("[Preview Scene] Left click released at (x={}, y={})", c.first, c.second);
     });
 
+    window.on_right_click([this]([[maybe_unused]] sdl::mouse_coord_t const c) noexcept -> void {
+        TRACE("[Preview Scene] Right click at (x={}, y={})", c.first, c.second);
+        m_selection_start = this->cell_under_mouse();
+        m_selection_end = { -1, -1 };
+    });
+
+    window.on_right_click_up([this]([[maybe_unused]] sdl::mouse_coord_t const c) noexcept -> void {
+        TRACE("[Preview Scene] Right click released at (x={}, y={})", c.first, c.second);
+        m_selection_end = this->cell_under_mouse();
+    });
+
     window.on_scroll([this, &view](sdl::mouse_coord_t const c) noexcept -> void {
         if(c.second != 0) {
             TRACE("[Preview Scene] Scroll up/down");
@@ -135,7 +179,7 @@ auto preview_scene::setup_event_handling(sdl::window& window, gol::view& view) n
 
     window.on_resize([&view](int const w, int const h) noexcept -> void {
         TRACE("[Preview Scene] Window resized: w={}, h={}", w, h);
-        view.set_aspect_ratio(static_cast<float>(w) / static_cast<float>(h));
+        view.set_viewport(w, h);
     });
 }
 
@@ -147,7 +191,7 @@ auto preview_scene::update(float const elapsed) noexcept -> void
     ASSERT(m_view != nullptr);
 
     if(m_dragging) {
-        auto const [grid_x, grid_y] = screen_to_grid(*m_window, *m_view, m_window->get_mouse_coord());
+        auto const [grid_x, grid_y] = this->cell_under_mouse();
 
         if(gol::coord{ grid_x, grid_y } != m_last_coord) {
             m_toggle = true;
@@ -161,6 +205,19 @@ auto preview_scene::update(float const elapsed) noexcept -> void
             m_view->toggle_at({ grid_x, grid_y });
         }
     }
+
+    // everything edited since the last frame goes out at once
+    if(m_view->upload_pending()) {
+        gol::scoped_timer const timer{ phase::upload };
+        static_cast<void>(m_view->upload_edits());
+    }
+}
+
+auto preview_scene::report_memory(memory_report& report) const -> void
+{
+    if(m_pattern.has_value()) {
+        report.add("editor", "pattern (bit grid)", m_pattern->memory_usage());
+    }
 }
 
 auto preview_scene::finished() const noexcept -> bool
@@ -5,6 +5,12 @@
 #include "coord.hpp"
 #include "scene.hpp"
 
+#include "engine/bit_grid.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <random>
+
 namespace gol {
 
 class preview_scene : public scene
@@ -20,18 +26,34 @@ private:
     bool m_finished = false;
     gol::coord m_last_coord = { -1, -1 };
 
+    // corners of the rectangle f, x and r work on, dragged out with the right button
+    gol::coord m_selection_start = { 0, 0 };
+    gol::coord m_selection_end = { -1, -1 };
+
+    // pasted at the cursor with p
+    std::optional<bit_grid> m_pattern;
+    double m_density = 0.0;
+    std::mt19937_64 m_rng;
+
+    [[nodiscard]] auto cell_under_mouse() const noexcept -> gol::coord;
+    [[nodiscard]] auto has_selection() const noexcept -> bool;
+
 public:
-    preview_scene() noexcept = default;
-    preview_scene(preview_scene const&) noexcept = default;
+    preview_scene() = default;
+    preview_scene(preview_scene const&) = default;
     preview_scene(preview_scene&&) noexcept = default;
     ~preview_scene() noexcept override = default;
 
-    auto operator=(preview_scene const&) noexcept -> preview_scene& = default;
+    // `density` is the chance of a cell being alive after a random fill, whose cells only depend on `seed`
+    preview_scene(std::optional<bit_grid> pattern, double density, std::uint64_t seed);
+
+    auto operator=(preview_scene const&) -> preview_scene& = default;
     auto operator=(preview_scene&&) noexcept -> preview_scene& = default;
 
     auto setup_event_handling(sdl::window& window, gol::view& view) noexcept -> void override;
     auto update(float elapsed) noexcept -> void override;
     [[nodiscard]] auto finished() const noexcept -> bool override;
+    auto report_memory(memory_report& report) const -> void override;
 };
 
 } // namespace gol
@@ -0,0 +1,166 @@
+#include "profiler.hpp"
+
+#include "thread/trace.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+namespace gol {
+
+auto phase_name(phase const p) noexcept -> char const*
+{
+    switch(p) {
+    case phase::events:
+        return "events";
+    case phase::generation:
+        return "generation";
+    case phase::apply:
+        return "apply";
+    case phase::upload:
+        return "upload";
+    case phase::draw:
+        return "draw";
+    case phase::swap:
+        return "swap";
+    case phase::frame:
+        return "frame";
+    default:
+        return "unknown";
+    }
+}
+
+auto profiler::get() noexcept -> profiler&
+{
+    static profiler inst;
+    return inst;
+}
+
+auto profiler::local_buffer() -> buffer&
+{
+    thread_local buffer* local = nullptr;
+
+    if(local == nullptr) {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_buffers.push_back(std::make_unique<buffer>());
+        local = m_buffers.back().get();
+    }
+
+    return *local;
+}
+
+auto profiler::record(phase const p, std::chrono::nanoseconds const elapsed) noexcept -> void
+{
+    // a full buffer means nobody is calling end_frame, dropping the sample is fine then
+    static_cast<void>(this->local_buffer().try_push({ p, elapsed.count() }));
+}
+
+auto profiler::end_frame() -> void
+{
+    std::array<std::int64_t, s_num_phases> frame_totals{};
+
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        sample s;
+
+        for(auto& buf : m_buffers) {
+            while(buf->try_pop(s)) {
+                auto const index = static_cast<std::size_t>(s.p);
+                auto& w = m_windows.at(index);
+
+                w.samples.at(w.next) = s.ns;
+                w.next = (w.next + 1) % s_window_size;
+                w.size = std::min(w.size + 1, s_window_size);
+                frame_totals.at(index) += s.ns;
+            }
+        }
+    }
+
+    if(m_csv.is_open()) {
+        constexpr double ns_to_ms = 1e-6;
+
+        m_csv << m_frame;
+        for(auto const total : frame_totals) {
+            m_csv << ',' << static_cast<double>(total) * ns_to_ms;
+        }
+        m_csv << '\n';
+    }
+
+    ++m_frame;
+}
+
+auto profiler::open_csv(std::string const& path) -> bool
+{
+    m_csv.open(path, std::ios::out | std::ios::trunc);
+
+    if(!m_csv.is_open()) {
+        return false;
+    }
+
+    m_csv << "frame";
+    for(std::size_t i = 0; i < s_num_phases; ++i) {
+        m_csv << ',' << phase_name(static_cast<phase>(i)) << " (ms)";
+    }
+    m_csv << '\n';
+
+    return true;
+}
+
+auto percentile(std::vector<double> samples, double const q) -> double
+{
+    if(samples.empty()) {
+        return 0.0;
+    }
+
+    auto const nth = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(nth), samples.end());
+
+    return samples[nth];
+}
+
+auto profiler::percentile(phase const p, double const q) const -> double
+{
+    auto const& w = m_windows.at(static_cast<std::size_t>(p));
+
+    constexpr double ns_to_ms = 1e-6;
+    std::vector<double> samples(w.size);
+    std::transform(w.samples.begin(),
+                   w.samples.begin() + static_cast<std::ptrdiff_t>(w.size),
+                   samples.begin(),
+                   [](std::int64_t const ns) { return static_cast<double>(ns) * ns_to_ms; });
+
+    return gol::percentile(std::move(samples), q);
+}
+
+auto profiler::summary() const -> std::string
+{
+    constexpr double p50 = 0.5;
+    constexpr double p99 = 0.99;
+
+    std::ostringstream ss;
+    ss.precision(3);
+    ss << std::fixed << "p50/p99 ms";
+
+    for(std::size_t i = 0; i < s_num_phases; ++i) {
+        auto const p = static_cast<phase>(i);
+        ss << " | " << phase_name(p) << ' ' << this->percentile(p, p50) << '/' << this->percentile(p, p99);
+    }
+
+    return ss.str();
+}
+
+scoped_timer::scoped_timer(phase const p) noexcept
+    : m_phase{ p }
+    , m_start{ std::chrono::steady_clock::now() }
+{
+}
+
+scoped_timer::~scoped_timer() noexcept
+{
+    auto const end = std::chrono::steady_clock::now();
+
+    profiler::get().record(m_phase, end - m_start);
+    tracer::get().record(phase_name(m_phase), m_start, end);
+}
+
+} // namespace gol
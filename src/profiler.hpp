@@ -0,0 +1,113 @@
+#ifndef GOL_PROFILER_HPP
+#define GOL_PROFILER_HPP
+#pragma once
+
+#include "thread/ring_buffer.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gol {
+
+enum class phase
+{
+    events,
+    generation,
+    apply,
+    upload,
+    draw,
+    swap,
+    // everything from the start of a drawn frame to its swap
+    frame,
+    count
+};
+
+[[nodiscard]] auto phase_name(phase p) noexcept -> char const*;
+
+// the sample below which a share `q` of `samples` lies, 0 if there are none
+[[nodiscard]] auto percentile(std::vector<double> samples, double q) -> double;
+
+class profiler
+{
+private:
+    static constexpr std::size_t s_num_phases = static_cast<std::size_t>(phase::count);
+    static constexpr std::size_t s_buffer_size = 1024;
+    static constexpr std::size_t s_window_size = 256;
+
+    struct sample
+    {
+        phase p = phase::events;
+        std::int64_t ns = 0;
+    };
+
+    // one per thread that records anything, only ever pushed to by its thread and popped by `end_frame`
+    using buffer = gol::ring_buffer<sample, s_buffer_size>;
+
+    struct window
+    {
+        std::array<std::int64_t, s_window_size> samples{};
+        std::size_t next = 0;
+        std::size_t size = 0;
+    };
+
+    // only guards registering new per-thread buffers, recording never takes it
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<buffer>> m_buffers;
+    std::array<window, s_num_phases> m_windows{};
+    std::ofstream m_csv;
+    long m_frame = 0;
+
+    profiler() = default;
+
+    [[nodiscard]] auto local_buffer() -> buffer&;
+
+public:
+    profiler(profiler const&) = delete;
+    profiler(profiler&&) noexcept = delete;
+    ~profiler() noexcept = default;
+
+    auto operator=(profiler const&) -> profiler& = delete;
+    auto operator=(profiler&&) noexcept -> profiler& = delete;
+
+    [[nodiscard]] static auto get() noexcept -> profiler&;
+
+    auto record(phase p, std::chrono::nanoseconds elapsed) noexcept -> void;
+
+    // collects what every thread recorded since the last frame, must be called from the main thread only
+    auto end_frame() -> void;
+
+    auto open_csv(std::string const& path) -> bool;
+
+    // in milliseconds, over the last `s_window_size` samples of the phase
+    [[nodiscard]] auto percentile(phase p, double q) const -> double;
+    [[nodiscard]] auto summary() const -> std::string;
+};
+
+class scoped_timer
+{
+private:
+    phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+
+public:
+    scoped_timer() = delete;
+    scoped_timer(scoped_timer const&) = delete;
+    scoped_timer(scoped_timer&&) noexcept = delete;
+    ~scoped_timer() noexcept;
+
+    explicit scoped_timer(phase p) noexcept;
+
+    auto operator=(scoped_timer const&) -> scoped_timer& = delete;
+    auto operator=(scoped_timer&&) noexcept -> scoped_timer& = delete;
+};
+
+} // namespace gol
+
+#endif // !GOL_PROFILER_HPP
@@ -0,0 +1,154 @@
+#include "render_bench.hpp"
+
+#include "profiler.hpp"
+#include "sdl.hpp"
+#include "view.hpp"
+
+#include "engine/change_set.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct timings
+{
+    std::vector<double> upload_ms;
+    std::vector<double> draw_ms;
+    std::size_t bytes = 0;
+    int level = 0;
+};
+
+[[nodiscard]] auto elapsed_ms(clock_type::time_point const start) -> double
+{
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+// glFinish() after every phase so the time includes what the driver deferred
+auto run(gol::view& view, gol::engine& e, gol::board& current, gol::board& shown, int const frames) -> timings
+{
+    timings t;
+    auto next = e.make_board(current.width(), current.height());
+    gol::change_set changes{ current.width(), current.height() };
+
+    for(int frame = 0; frame < frames; ++frame) {
+        e.step(current, next);
+        std::swap(current, next);
+
+        changes.record(shown, current);
+        changes.apply(shown);
+        view.apply(changes, shown);
+        changes.clear();
+
+        auto start = clock_type::now();
+        t.bytes += view.upload(shown);
+        glFinish();
+        t.upload_ms.push_back(elapsed_ms(start));
+
+        start = clock_type::now();
+        view.invalidate();
+        view.update();
+        glFinish();
+        t.draw_ms.push_back(elapsed_ms(start));
+    }
+
+    t.level = view.level();
+
+    return t;
+}
+
+auto report(std::ostream& out, char const* name, timings const& t, int const frames) -> void
+{
+    constexpr double p50 = 0.5;
+    constexpr double p99 = 0.99;
+
+    out << std::fixed << std::setprecision(3) << name << " (level " << t.level << "): upload p50/p99 "
+        << gol::percentile(t.upload_ms, p50) << '/' << gol::percentile(t.upload_ms, p99) << " ms, draw p50/p99 "
+        << gol::percentile(t.draw_ms, p50) << '/' << gol::percentile(t.draw_ms, p99) << " ms, "
+        << static_cast<double>(t.bytes) / frames / 1024.0 << " KB uploaded per frame\n";
+}
+
+} // namespace
+
+namespace gol {
+
+auto run_render_bench(render_bench_config const& config, engine& e, std::ostream& out) -> int
+{
+    sdl::window window{ "GameOfLife", config.viewport_width, config.viewport_height, sdl::window_mode::hidden };
+
+    if(!window.has_gl_context()) {
+        out << "Could not create an OpenGL context, try SDL_VIDEODRIVER=offscreen or LIBGL_ALWAYS_SOFTWARE=1\n";
+        return 1;
+    }
+
+    unsigned int framebuffer = 0;
+    unsigned int color = 0;
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, config.viewport_width, config.viewport_height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+
+    int result = 0;
+
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        out << "Could not create a framebuffer to render into\n";
+        result = 1;
+    }
+    else {
+        glViewport(0, 0, config.viewport_width, config.viewport_height);
+
+        out << "renderer: " << reinterpret_cast<char const*>(glGetString(GL_RENDERER)) // NOLINT
+            << ", board " << config.width << 'x' << config.height << ", viewport " << config.viewport_width << 'x'
+            << config.viewport_height << ", " << config.frames << " frames\n";
+
+        // a third of the cells alive, the same board every run
+        constexpr unsigned seed = 1;
+        std::mt19937 rng{ seed };
+        auto current = e.make_board(config.width, config.height);
+
+        for(int y = 0; y < config.height; ++y) {
+            for(int x = 0; x < config.width; ++x) {
+                current.at(x, y) = static_cast<unsigned char>(rng() % 3 == 0);
+            }
+        }
+
+        try {
+            gol::view view{ config.width, config.height };
+            view.set_viewport(config.viewport_width, config.viewport_height);
+            board shown{ config.width, config.height };
+
+            report(out, "close up", run(view, e, current, shown, config.frames), config.frames);
+
+            // back far enough that the whole board fits vertically and horizontally
+            float const extent = view::cell_dimension() * static_cast<float>(std::max(config.width, config.height));
+            float const distance = extent / 2.0F * view.projection_matrix()[1][1];
+            view.translate({ 0.0F, 0.0F, -(distance + view.view_matrix()[3][2]) });
+
+            report(out, "whole board", run(view, e, current, shown, config.frames), config.frames);
+        }
+        catch(std::length_error const& error) {
+            out << error.what() << '\n';
+            result = 1;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteRenderbuffers(1, &color);
+    glDeleteFramebuffers(1, &framebuffer);
+
+    return result;
+}
+
+} // namespace gol
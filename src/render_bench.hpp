@@ -0,0 +1,28 @@
+#ifndef GOL_RENDER_BENCH_HPP
+#define GOL_RENDER_BENCH_HPP
+#pragma once
+
+#include "engine/engine.hpp"
+
+#include <ostream>
+
+namespace gol {
+
+struct render_bench_config
+{
+    int width = 0;
+    int height = 0;
+    // at least 1
+    int frames = 0;
+    int viewport_width = 0;
+    int viewport_height = 0;
+};
+
+// Steps a random board and pushes every generation through gol::view in a hidden window, rendering into a framebuffer
+// object. Reports upload and draw times once with the default camera and once zoomed out to the whole board. Returns
+// the process exit code.
+auto run_render_bench(render_bench_config const& config, engine& e, std::ostream& out) -> int;
+
+} // namespace gol
+
+#endif // !GOL_RENDER_BENCH_HPP
@@ -2,6 +2,7 @@
 #define GOL_SCENE_HPP
 #pragma once
 
+#include "memory.hpp"
 #include "sdl.hpp"
 #include "view.hpp"
 
@@ -21,6 +22,11 @@ public:
     virtual auto setup_event_handling(sdl::window& window, gol::view& view) noexcept -> void = 0;
     virtual auto update(float elapsed) noexcept -> void = 0;
     [[nodiscard]] virtual auto finished() const noexcept -> bool = 0;
+
+    // adds the big buffers the scene holds, the view reports its own
+    virtual auto report_memory([[maybe_unused]] memory_report& report) const -> void
+    {
+    }
 };
 
 } // namespace gol
@@ -7,6 +7,10 @@
 #include <glad/glad.h>
 #include <spdlog/spdlog.h>
 
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+
 namespace sdl {
 
 initializer::initializer() noexcept
@@ -32,36 +36,71 @@ auto initializer::initialize() noexcept -> void
     static_cast<void>(inst);
 }
 
-window::window(std::string const& title, int const w, int const h) noexcept
+window::window(std::string const& title, int const w, int const h, window_mode const mode) noexcept
+    : m_width{ w }
+    , m_height{ h }
 {
+    bool const hidden = mode == window_mode::hidden;
+
+    // has to be decided before SDL_Init
+    bool const has_display = std::getenv("DISPLAY") != nullptr || std::getenv("WAYLAND_DISPLAY") != nullptr;
+    if(hidden && !has_display && std::getenv("SDL_VIDEODRIVER") == nullptr) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+    }
+
     initializer::initialize();
 
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
 
-    m_window = SDL_CreateWindow(
-        title.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, w, h, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
-    ASSERT_MSG(m_window != nullptr, SDL_GetError());
+    Uint32 const flags = SDL_WINDOW_OPENGL | (hidden ? SDL_WINDOW_HIDDEN : SDL_WINDOW_RESIZABLE);
+    m_window = SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, w, h, flags);
+
+    if(hidden) {
+        if(m_window == nullptr) {
+            ERROR("Could not create a hidden window: {}", SDL_GetError());
+            return;
+        }
+    }
+    else {
+        ASSERT_MSG(m_window != nullptr, SDL_GetError());
 
-    m_renderer = SDL_CreateRenderer(m_window, -1, SDL_RENDERER_ACCELERATED);
-    ASSERT_MSG(m_renderer != nullptr, SDL_GetError());
+        m_renderer = SDL_CreateRenderer(m_window, -1, SDL_RENDERER_ACCELERATED);
+        ASSERT_MSG(m_renderer != nullptr, SDL_GetError());
+    }
 
     m_gl_context = SDL_GL_CreateContext(m_window);
 
+    if(m_gl_context == nullptr) {
+        ERROR("Could not create an OpenGL context: {}", SDL_GetError());
+        return;
+    }
+
     [[maybe_unused]] auto const glad_loaded = gladLoadGLLoader(static_cast<GLADloadproc>(SDL_GL_GetProcAddress));
     ASSERT(glad_loaded != 0);
 
-    SDL_GL_SetSwapInterval(1);
+    SDL_GL_SetSwapInterval(hidden ? 0 : 1);
 
     INFO("OpenGL context created! Version {}.{}", GLVersion.major, GLVersion.minor);
 }
 
 window::~window() noexcept
 {
-    SDL_GL_DeleteContext(m_gl_context);
-    SDL_DestroyRenderer(m_renderer);
-    SDL_DestroyWindow(m_window);
+    if(m_gl_context != nullptr) {
+        SDL_GL_DeleteContext(m_gl_context);
+    }
+    if(m_renderer != nullptr) {
+        SDL_DestroyRenderer(m_renderer);
+    }
+    if(m_window != nullptr) {
+        SDL_DestroyWindow(m_window);
+    }
+}
+
+auto window::has_gl_context() const noexcept -> bool
+{
+    return m_gl_context != nullptr;
 }
 
 auto window::should_close() const noexcept -> bool
@@ -79,9 +118,17 @@ auto window::swap_buffers() const noexcept -> void
     SDL_GL_SwapWindow(m_window);
 }
 
+auto window::set_title(std::string const& title) noexcept -> void
+{
+    SDL_SetWindowTitle(m_window, title.c_str());
+}
+
 auto window::get_mouse_coord() const noexcept -> mouse_coord_t
 {
-    static_cast<void>(m_window); // ignore 'method can be made static'
+    if(m_replaying) {
+        return m_mouse;
+    }
+
     int x = 0;
     int y = 0;
 
@@ -100,23 +147,105 @@ auto window::height() const noexcept -> int
     return m_height;
 }
 
-auto window::handle_events() -> void
+auto window::dispatch(input_event ev) -> void
+{
+    if(m_recording != nullptr) {
+        ev.frame = m_frame;
+        ev.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_recording_start)
+                         .count();
+        write_event(*m_recording, ev);
+    }
+
+    mouse_coord_t const c = { ev.a, ev.b };
+
+    switch(ev.kind) {
+    case input_kind::key_press: {
+        m_on_key_press(static_cast<key_event>(ev.a));
+        break;
+    }
+    case input_kind::left_click: {
+        m_on_left_click(c);
+        break;
+    }
+    case input_kind::left_click_up: {
+        m_on_left_click_up(c);
+        break;
+    }
+    case input_kind::right_click: {
+        m_on_right_click(c);
+        break;
+    }
+    case input_kind::right_click_up: {
+        m_on_right_click_up(c);
+        break;
+    }
+    case input_kind::scroll: {
+        m_on_scroll(c);
+        break;
+    }
+    case input_kind::resize: {
+        if(m_replaying) {
+            SDL_SetWindowSize(m_window, ev.a, ev.b);
+        }
+
+        m_width = ev.a;
+        m_height = ev.b;
+        glViewport(0, 0, m_width, m_height);
+        m_on_resize(m_width, m_height);
+        break;
+    }
+    case input_kind::mouse: {
+        m_mouse = c;
+        break;
+    }
+    case input_kind::quit: {
+        m_should_close = true;
+        break;
+    }
+    }
+}
+
+auto window::handle_events(int const wait_ms) -> void
 {
+    ++m_frame;
+
     SDL_Event ev;
+    // a replay runs at full speed, it's a benchmark
+    bool pending = wait_ms > 0 && !m_replaying ? SDL_WaitEventTimeout(&ev, wait_ms) != 0 : SDL_PollEvent(&ev) != 0;
+
+    // scenes ask for the mouse position while handling this frame's events, so it goes first. Waiting or polling
+    // pumped every event there is into SDL's mouse state already.
+    if(m_recording != nullptr) {
+        int x = 0;
+        int y = 0;
+        SDL_GetMouseState(&x, &y);
+
+        if(mouse_coord_t{ x, y } != m_mouse) {
+            this->dispatch({ 0, 0.0, input_kind::mouse, x, y });
+        }
+    }
+
+    for(; pending; pending = SDL_PollEvent(&ev) != 0) {
+        input_event in;
 
-    while(static_cast<bool>(SDL_PollEvent(&ev))) {
         switch(ev.type) {
         case SDL_QUIT: {
-            m_should_close = true;
+            in.kind = input_kind::quit;
             break;
         }
+        case SDL_USEREVENT: {
+            m_wake_pending.store(false, std::memory_order_relaxed);
+            continue;
+        }
         case SDL_WINDOWEVENT: {
-            if(ev.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
-                m_width = ev.window.data1;
-                m_height = ev.window.data2;
-                glViewport(0, 0, m_width, m_height);
-                m_on_resize(m_width, m_height);
+            if(ev.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                m_exposed = true;
+            }
+            if(ev.window.event != SDL_WINDOWEVENT_SIZE_CHANGED) {
+                continue;
             }
+
+            in = { 0, 0.0, input_kind::resize, ev.window.data1, ev.window.data2 };
             break;
         }
         case SDL_KEYDOWN: {
@@ -155,32 +284,138 @@ auto window::handle_events() -> void
                 key = key_event::vk_s;
                 break;
             }
+            case SDLK_e: {
+                key = key_event::vk_e;
+                break;
             }
-
-            m_on_key_press(key);
-            break;
-        }
-        case SDL_MOUSEBUTTONDOWN: {
-            if(ev.button.button == SDL_BUTTON_LEFT) {
-                m_on_left_click({ ev.button.x, ev.button.y });
+            case SDLK_c: {
+                key = key_event::vk_c;
+                break;
+            }
+            case SDLK_f: {
+                key = key_event::vk_f;
+                break;
+            }
+            case SDLK_x: {
+                key = key_event::vk_x;
+                break;
+            }
+            case SDLK_r: {
+                key = key_event::vk_r;
+                break;
             }
+            case SDLK_p: {
+                key = key_event::vk_p;
+                break;
+            }
+            case SDLK_m: {
+                key = key_event::vk_m;
+                break;
+            }
+            }
+
+            in = { 0, 0.0, input_kind::key_press, static_cast<int>(key), 0 };
             break;
         }
+        case SDL_MOUSEBUTTONDOWN:
         case SDL_MOUSEBUTTONUP: {
+            bool const down = ev.type == SDL_MOUSEBUTTONDOWN;
+
             if(ev.button.button == SDL_BUTTON_LEFT) {
-                m_on_left_click_up({ ev.button.x, ev.button.y });
+                in.kind = down ? input_kind::left_click : input_kind::left_click_up;
             }
+            else if(ev.button.button == SDL_BUTTON_RIGHT) {
+                in.kind = down ? input_kind::right_click : input_kind::right_click_up;
+            }
+            else {
+                continue;
+            }
+
+            in.a = ev.button.x;
+            in.b = ev.button.y;
             break;
         }
         case SDL_MOUSEWHEEL: {
-            m_on_scroll({ ev.wheel.x, ev.wheel.y });
+            in = { 0, 0.0, input_kind::scroll, ev.wheel.x, ev.wheel.y };
             break;
         }
         default: {
-            break;
+            continue;
         }
         }
+
+        // closing the window still works during a replay, the rest of the real input doesn't
+        if(!m_replaying || in.kind == input_kind::quit) {
+            this->dispatch(in);
+        }
     }
+
+    if(m_replaying) {
+        while(m_next_event < m_script.size() && m_script[m_next_event].frame <= m_frame) {
+            this->dispatch(m_script[m_next_event++]);
+        }
+
+        if(m_next_event == m_script.size()) {
+            m_should_close = true;
+        }
+    }
+}
+
+auto window::wake() noexcept -> void
+{
+    if(!m_wake_pending.exchange(true, std::memory_order_relaxed)) {
+        SDL_Event ev{};
+        ev.type = SDL_USEREVENT;
+        SDL_PushEvent(&ev);
+    }
+}
+
+auto window::take_exposed() noexcept -> bool
+{
+    return std::exchange(m_exposed, false);
+}
+
+auto window::record(std::string const& path) -> bool
+{
+    auto file = std::make_unique<std::ofstream>(path);
+
+    if(!*file) {
+        return false;
+    }
+
+    *file << "# frame time_ms event [args]\n";
+    m_recording = std::move(file);
+    m_recording_start = std::chrono::steady_clock::now();
+    m_mouse = { -1, -1 };
+
+    return true;
+}
+
+auto window::replay(std::string const& path) -> bool
+{
+    std::ifstream file{ path };
+
+    if(!file) {
+        return false;
+    }
+
+    auto script = read_script(file);
+
+    if(!script.has_value()) {
+        return false;
+    }
+
+    m_script = std::move(*script);
+    m_next_event = 0;
+    m_replaying = true;
+    m_mouse = { 0, 0 };
+
+    return true;
+}
+
+auto window::replaying() const noexcept -> bool
+{
+    return m_replaying;
 }
 
 } // namespace sdl
@@ -2,10 +2,17 @@
 #define GOL_SDL_HPP
 #pragma once
 
+#include "input_script.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
 #include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 struct SDL_Window;
 struct SDL_Renderer;
@@ -32,21 +39,14 @@ public:
     static auto initialize() noexcept -> void;
 };
 
-enum class key_event
+enum class window_mode
 {
-    vk_escape,
-    vk_space,
-    vk_up,
-    vk_down,
-    vk_left,
-    vk_right,
-    vk_w,
-    vk_s,
-    vk_none
+    visible,
+    // Never shown, for rendering into framebuffer objects. Without a display SDL's offscreen driver is used, which
+    // gets a context from EGL (llvmpipe with LIBGL_ALWAYS_SOFTWARE=1).
+    hidden
 };
 
-using mouse_coord_t = std::pair<int, int>;
-
 class window
 {
 private:
@@ -55,6 +55,9 @@ private:
     SDL_GLContext m_gl_context{ nullptr };
 
     bool m_should_close{ false };
+    bool m_exposed{ false };
+    // a wake up event is in SDL's queue
+    std::atomic<bool> m_wake_pending{ false };
 
     static constexpr int s_default_width = 1280;
     static constexpr int s_default_height = 720;
@@ -65,30 +68,67 @@ private:
     std::function<void(key_event)> m_on_key_press = []([[maybe_unused]] key_event ev) {};
     std::function<void(mouse_coord_t)> m_on_left_click = []([[maybe_unused]] mouse_coord_t ev) {};
     std::function<void(mouse_coord_t)> m_on_left_click_up = []([[maybe_unused]] mouse_coord_t ev) {};
+    std::function<void(mouse_coord_t)> m_on_right_click = []([[maybe_unused]] mouse_coord_t ev) {};
+    std::function<void(mouse_coord_t)> m_on_right_click_up = []([[maybe_unused]] mouse_coord_t ev) {};
     std::function<void(mouse_coord_t)> m_on_scroll = []([[maybe_unused]] mouse_coord_t ev) {};
     std::function<void(int, int)> m_on_resize = []([[maybe_unused]] int a, [[maybe_unused]] int b) {};
 
+    // handle_events() calls so far
+    long m_frame = 0;
+    std::unique_ptr<std::ofstream> m_recording;
+    std::chrono::steady_clock::time_point m_recording_start;
+    std::vector<input_event> m_script;
+    std::size_t m_next_event = 0;
+    bool m_replaying = false;
+    // the last mouse position recorded or replayed
+    mouse_coord_t m_mouse{ -1, -1 };
+
+    // records `ev` when recording and calls its callback
+    auto dispatch(input_event ev) -> void;
+
 public:
     window() = delete;
-    window(window const&) noexcept = default;
-    window(window&&) noexcept = default;
+    window(window const&) = delete;
+    window(window&&) noexcept = delete;
     ~window() noexcept;
 
-    explicit window(std::string const& title, int w = s_default_width, int h = s_default_height) noexcept;
+    explicit window(std::string const& title,
+                    int w = s_default_width,
+                    int h = s_default_height,
+                    window_mode mode = window_mode::visible) noexcept;
 
-    auto operator=(window const&) noexcept -> window& = default;
-    auto operator=(window&&) noexcept -> window& = default;
+    auto operator=(window const&) -> window& = delete;
+    auto operator=(window&&) noexcept -> window& = delete;
 
     [[nodiscard]] auto width() const noexcept -> int;
     [[nodiscard]] auto height() const noexcept -> int;
+    // false if the window or its OpenGL context couldn't be created
+    [[nodiscard]] auto has_gl_context() const noexcept -> bool;
 
     [[nodiscard]] auto should_close() const noexcept -> bool;
     auto request_close() noexcept -> void;
 
     auto swap_buffers() const noexcept -> void;
+    auto set_title(std::string const& title) noexcept -> void;
 
-    auto handle_events() -> void;
+    // Calls the callbacks of what happened since the last call, waiting up to `wait_ms` for something to happen if
+    // nothing did. While replaying, input comes from the script instead of SDL without waiting, and the window closes
+    // after the script's last frame.
+    auto handle_events(int wait_ms = 0) -> void;
     [[nodiscard]] auto get_mouse_coord() const noexcept -> mouse_coord_t;
+    // Makes a handle_events() that waits for input return, or the next one not wait. Safe to call from any thread,
+    // calls before the event is handled add nothing to the queue.
+    auto wake() noexcept -> void;
+    // true once after the window was uncovered and its contents have to be drawn again
+    [[nodiscard]] auto take_exposed() noexcept -> bool;
+
+    // Every callback from now on is written to `path` with the frame and time it happened at. False if the file
+    // can't be opened.
+    auto record(std::string const& path) -> bool;
+    // Input comes from a file written by record(), frame by frame, and the real keyboard and mouse are ignored. False
+    // if the file can't be read.
+    auto replay(std::string const& path) -> bool;
+    [[nodiscard]] auto replaying() const noexcept -> bool;
 
     template<typename F>
     auto on_key_press(F f) -> void
@@ -108,6 +148,18 @@ public:
         m_on_left_click_up = f;
     }
 
+    template<typename F>
+    auto on_right_click(F f) -> void
+    {
+        m_on_right_click = f;
+    }
+
+    template<typename F>
+    auto on_right_click_up(F f) -> void
+    {
+        m_on_right_click_up = f;
+    }
+
     template<typename F>
     auto on_scroll(F f) -> void
     {
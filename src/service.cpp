@@ -0,0 +1,596 @@
+#include "service.hpp"
+
+#include "log.hpp"
+
+#include "engine/bit_grid.hpp"
+#include "engine/pattern.hpp"
+#include "thread/metrics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+
+std::atomic<bool> g_stop_requested{ false };
+
+gol::metric g_sessions{ "gol_service_sessions", "Sessions open in --serve mode", gol::metric_kind::gauge };
+gol::metric g_batches{ "gol_service_batches_total",
+                       "Batches of steps dispatched to the thread pool in --serve mode",
+                       gol::metric_kind::counter };
+gol::metric g_service_generations{ "gol_service_generations_total",
+                                   "Generations stepped over every session in --serve mode",
+                                   gol::metric_kind::counter };
+
+constexpr std::size_t s_max_line = 4096;
+// biggest pattern a client can send with `load`
+constexpr std::size_t s_max_pattern_size = std::size_t{ 64 } << 20U;
+constexpr long s_max_cells = long{ 1 } << 30;
+
+// the next line from `client` without its line ending, nullopt once the client is gone or sends a line that's too
+// long. `buffered` keeps what was received past the line.
+[[nodiscard]] auto read_line(gol::socket const& client, std::string& buffered) -> std::optional<std::string>
+{
+    std::array<char, 4096> chunk{};
+
+    for(;;) {
+        if(auto const end = buffered.find('\n'); end != std::string::npos) {
+            auto line = buffered.substr(0, end);
+            buffered.erase(0, end + 1);
+
+            if(!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            return line;
+        }
+
+        if(buffered.size() > s_max_line) {
+            return std::nullopt;
+        }
+
+        auto const received = client.receive(chunk.data(), chunk.size());
+        if(received == 0) {
+            return std::nullopt;
+        }
+
+        buffered.append(chunk.data(), received);
+    }
+}
+
+[[nodiscard]] auto read_bytes(gol::socket const& client, std::string& buffered, std::size_t const size)
+    -> std::optional<std::string>
+{
+    std::array<char, 4096> chunk{};
+
+    while(buffered.size() < size) {
+        auto const received = client.receive(chunk.data(), chunk.size());
+        if(received == 0) {
+            return std::nullopt;
+        }
+
+        buffered.append(chunk.data(), received);
+    }
+
+    auto bytes = buffered.substr(0, size);
+    buffered.erase(0, size);
+
+    return bytes;
+}
+
+[[nodiscard]] auto error(std::string const& why) -> std::string
+{
+    return "error " + why + '\n';
+}
+
+[[nodiscard]] auto ok(long const value) -> std::string
+{
+    return "ok " + std::to_string(value) + '\n';
+}
+
+} // namespace
+
+namespace gol {
+
+service::reservation::~reservation() noexcept
+{
+    if(m_total != nullptr) {
+        m_total->fetch_sub(m_bytes, std::memory_order_relaxed);
+    }
+}
+
+auto service::reservation::reserve(std::atomic<std::size_t>& total,
+                                   std::size_t const bytes,
+                                   std::size_t const limit) noexcept -> bool
+{
+    auto used = total.load(std::memory_order_relaxed);
+
+    do {
+        if(limit > 0 && used + bytes > limit) {
+            return false;
+        }
+    } while(!total.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+
+    m_total = &total;
+    m_bytes = bytes;
+
+    return true;
+}
+
+service::service(gol::rule const& r,
+                 gol::topology const t,
+                 std::size_t const num_threads,
+                 std::size_t const max_memory)
+    : m_rule{ r }
+    , m_topology{ t }
+    , m_max_memory{ max_memory }
+    , m_threadpool{ std::max<std::size_t>(num_threads, 1) }
+{
+    m_stepper = std::thread{ [this] { this->step_batches(); } };
+}
+
+service::~service() noexcept
+{
+    {
+        std::lock_guard<std::mutex> const lock{ m_steps_mutex };
+        m_stop.store(true, std::memory_order_release);
+    }
+    m_steps_cv.notify_all();
+    m_stepper.join();
+}
+
+auto service::request_stop() noexcept -> void
+{
+    g_stop_requested.store(true, std::memory_order_relaxed);
+}
+
+auto service::find(long const id) -> std::shared_ptr<session>
+{
+    std::lock_guard<std::mutex> const lock{ m_sessions_mutex };
+
+    auto const it = m_sessions.find(id);
+    return it == m_sessions.end() ? nullptr : it->second;
+}
+
+auto service::add(std::shared_ptr<session> s) -> long
+{
+    std::lock_guard<std::mutex> const lock{ m_sessions_mutex };
+
+    auto const id = m_next_session++;
+    m_sessions.emplace(id, std::move(s));
+    g_sessions.move(1);
+
+    return id;
+}
+
+auto service::make_session(int const w, int const h) -> std::shared_ptr<session>
+{
+    auto s = std::make_shared<session>();
+
+    if(!s->memory.reserve(m_session_memory, 2 * gol::board::memory_usage(w, h), m_max_memory)) {
+        return nullptr;
+    }
+
+    s->current = gol::board{ w, h };
+    s->next = gol::board{ w, h };
+
+    return s;
+}
+
+auto service::step_slice(step_request& r) -> void
+{
+    auto& s = *r.target;
+    std::lock_guard<std::mutex> const lock{ s.mutex };
+
+    auto const cells = std::max<std::size_t>(
+        static_cast<std::size_t>(s.current.width()) * static_cast<std::size_t>(s.current.height()), 1);
+    auto const slice = std::min(r.remaining, static_cast<long>(std::max<std::size_t>(s_slice_cells / cells, 1)));
+
+    for(long i = 0; i < slice; ++i) {
+        s.engine.step(s.current, s.next);
+        std::swap(s.current, s.next);
+    }
+
+    s.generation += slice;
+    r.remaining -= slice;
+    r.generation = s.generation;
+    g_service_generations.increment(slice);
+}
+
+auto service::step_batches() -> void
+{
+    // requests that need more than one slice stay here between batches
+    std::vector<step_request> batch;
+    std::vector<step_request*> runnable;
+    std::unordered_set<session const*> seen;
+
+    for(;;) {
+        {
+            std::unique_lock<std::mutex> lock{ m_steps_mutex };
+            m_steps_cv.wait(lock, [this, &batch] {
+                return m_stop.load(std::memory_order_acquire) || !m_steps.empty() || !batch.empty();
+            });
+
+            if(m_stop.load(std::memory_order_acquire)) {
+                std::move(m_steps.begin(), m_steps.end(), std::back_inserter(batch));
+                m_steps.clear();
+                break;
+            }
+
+            std::move(m_steps.begin(), m_steps.end(), std::back_inserter(batch));
+            m_steps.clear();
+        }
+
+        // a session is stepped by one task at a time, its later requests wait for the next batch to stay in order
+        runnable.clear();
+        seen.clear();
+        for(auto& r : batch) {
+            if(seen.insert(r.target.get()).second) {
+                runnable.push_back(&r);
+            }
+        }
+
+        m_threadpool.parallel_for(
+            0,
+            runnable.size(),
+            1,
+            [&runnable](std::size_t const begin, std::size_t const end) {
+                for(auto i = begin; i < end; ++i) {
+                    step_slice(*runnable[i]);
+                }
+            },
+            schedule::dynamic_chunks);
+        g_batches.increment();
+
+        auto const finished = std::stable_partition(
+            batch.begin(), batch.end(), [](step_request const& r) { return r.remaining > 0 || r.generation < 0; });
+
+        for(auto it = finished; it != batch.end(); ++it) {
+            it->done.set_value(it->generation);
+        }
+        batch.erase(finished, batch.end());
+    }
+
+    for(auto& r : batch) {
+        r.done.set_exception(std::make_exception_ptr(std::runtime_error{ "the service is shutting down" }));
+    }
+}
+
+auto service::execute(std::string const& line, gol::socket const& client, std::string& buffered) -> std::string
+{
+    std::istringstream in{ line };
+    std::string command;
+    in >> command;
+
+    if(command == "create") {
+        int w = 0;
+        int h = 0;
+        std::string rule;
+        std::string topology;
+
+        if(!(in >> w >> h) || w <= 0 || h <= 0 || static_cast<long>(w) * h > s_max_cells) {
+            return error("usage: create <w> <h> [<rule> [bounded|torus]], at most 2^30 cells");
+        }
+
+        in >> rule >> topology;
+
+        auto const r = rule.empty() ? std::optional<gol::rule>{ m_rule } : gol::parse_rule(rule);
+        if(!r.has_value()) {
+            return error("invalid rule " + rule);
+        }
+
+        auto const t = topology.empty() ? std::optional<gol::topology>{ m_topology } : gol::parse_topology(topology);
+        if(!t.has_value()) {
+            return error("unknown topology " + topology);
+        }
+
+        auto s = this->make_session(w, h);
+        if(s == nullptr) {
+            return error("out of memory, --max-memory is reached");
+        }
+
+        s->engine.set_rule(*r);
+        s->engine.set_topology(*t);
+
+        return ok(this->add(std::move(s)));
+    }
+
+    if(command == "load") {
+        long id = 0;
+        int x = 0;
+        int y = 0;
+        std::size_t size = 0;
+
+        if(!(in >> id >> x >> y >> size) || size > s_max_pattern_size) {
+            return error("usage: load <session> <x> <y> <size>, at most 64 MiB");
+        }
+
+        // read before anything can fail, so the next command starts where it should
+        auto const text = read_bytes(client, buffered, size);
+        if(!text.has_value()) {
+            return error("the pattern was cut off");
+        }
+
+        auto const s = this->find(id);
+        if(s == nullptr) {
+            return error("unknown session " + std::to_string(id));
+        }
+
+        std::unique_lock<std::mutex> lock{ s->mutex };
+        auto const width = s->current.width();
+        auto const height = s->current.height();
+        lock.unlock();
+
+        // no bigger than the board, and counted like one while it's around
+        reservation grid;
+        if(!grid.reserve(m_session_memory, gol::bit_grid::memory_usage(width, height), m_max_memory)) {
+            return error("out of memory, --max-memory is reached");
+        }
+
+        auto const pattern = gol::read_pattern(*text, width, height);
+        if(!pattern.has_value()) {
+            return error("could not read the pattern, or it's bigger than the board");
+        }
+
+        lock.lock();
+
+        // in long, x and y come straight from the client and can be anywhere in int's range
+        long const x0 = x;
+        long const y0 = y;
+        auto const rows = std::min<long>(pattern->height(), s->current.height() - y0);
+        auto const columns = std::min<long>(pattern->width(), s->current.width() - x0);
+
+        for(auto py = std::max(0L, -y0); py < rows; ++py) {
+            for(auto px = std::max(0L, -x0); px < columns; ++px) {
+                s->current.at(static_cast<int>(x0 + px), static_cast<int>(y0 + py)) =
+                    pattern->test(static_cast<int>(px), static_cast<int>(py)) ? gol::board::s_alive
+                                                                              : gol::board::s_dead;
+            }
+        }
+
+        return "ok\n";
+    }
+
+    if(command == "step") {
+        std::vector<long> numbers;
+        for(long number = 0; in >> number;) {
+            numbers.push_back(number);
+        }
+
+        if(!in.eof() || numbers.empty() || numbers.size() % 2 != 0) {
+            return error("usage: step <session> <n> [<session> <n> ...]");
+        }
+
+        std::vector<step_request> requests(numbers.size() / 2);
+        std::vector<std::future<long>> done;
+
+        for(std::size_t i = 0; i < requests.size(); ++i) {
+            auto const id = numbers[2 * i];
+            auto const n = numbers[2 * i + 1];
+
+            if(n < 0) {
+                return error("usage: step <session> <n> [<session> <n> ...]");
+            }
+
+            requests[i].target = this->find(id);
+            if(requests[i].target == nullptr) {
+                return error("unknown session " + std::to_string(id));
+            }
+
+            requests[i].remaining = n;
+            done.push_back(requests[i].done.get_future());
+        }
+
+        {
+            std::lock_guard<std::mutex> const lock{ m_steps_mutex };
+
+            // the stepper is gone or about to be
+            if(m_stop.load(std::memory_order_acquire)) {
+                return error("the service is shutting down");
+            }
+
+            std::move(requests.begin(), requests.end(), std::back_inserter(m_steps));
+        }
+        m_steps_cv.notify_one();
+
+        std::string answer = "ok";
+        for(auto& d : done) {
+            answer += ' ' + std::to_string(d.get());
+        }
+
+        return answer + '\n';
+    }
+
+    if(command == "read") {
+        long id = 0;
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+
+        if(!(in >> id >> x >> y >> w >> h) || x < 0 || y < 0 || w < 0 || h < 0) {
+            return error("usage: read <session> <x> <y> <w> <h>");
+        }
+
+        auto const s = this->find(id);
+        if(s == nullptr) {
+            return error("unknown session " + std::to_string(id));
+        }
+
+        std::lock_guard<std::mutex> const lock{ s->mutex };
+
+        if(static_cast<long>(x) + w > s->current.width() || static_cast<long>(y) + h > s->current.height()) {
+            return error("the region is outside the board");
+        }
+
+        auto bytes = pack_cells(s->current, x, y, w, h);
+        return "ok " + std::to_string(bytes.size()) + '\n' + std::move(bytes);
+    }
+
+    if(command == "hash" || command == "snapshot" || command == "close") {
+        long id = 0;
+
+        if(!(in >> id)) {
+            return error("usage: " + command + " <session>");
+        }
+
+        auto const s = this->find(id);
+        if(s == nullptr) {
+            return error("unknown session " + std::to_string(id));
+        }
+
+        if(command == "hash") {
+            std::lock_guard<std::mutex> const lock{ s->mutex };
+            return "ok " + std::to_string(s->current.hash()) + '\n';
+        }
+
+        if(command == "snapshot") {
+            auto copy = this->make_session(s->current.width(), s->current.height());
+            if(copy == nullptr) {
+                return error("out of memory, --max-memory is reached");
+            }
+
+            {
+                std::lock_guard<std::mutex> const lock{ s->mutex };
+                copy->current = s->current;
+                copy->engine.set_rule(s->engine.rule());
+                copy->engine.set_topology(s->engine.topology());
+                copy->generation = s->generation;
+            }
+
+            return ok(this->add(std::move(copy)));
+        }
+
+        // steps still queued keep it alive until they're done
+        std::lock_guard<std::mutex> const lock{ m_sessions_mutex };
+        if(m_sessions.erase(id) > 0) {
+            g_sessions.move(-1);
+        }
+
+        return "ok\n";
+    }
+
+    if(command == "shutdown") {
+        request_stop();
+        return "ok\n";
+    }
+
+    return error("unknown command " + command);
+}
+
+auto service::serve(gol::socket const& client) -> void
+{
+    std::string buffered;
+
+    while(auto const line = read_line(client, buffered)) {
+        if(line->empty()) {
+            continue;
+        }
+
+        std::string answer;
+
+        try {
+            answer = this->execute(*line, client, buffered);
+        }
+        catch(std::exception const& e) {
+            answer = error(e.what());
+        }
+
+        if(!client.send(answer)) {
+            break;
+        }
+    }
+}
+
+auto service::run(std::string const& address) -> bool
+{
+    auto const listener = gol::listen_local(address);
+
+    if(!listener.valid()) {
+        return false;
+    }
+
+    struct connection
+    {
+        gol::socket client;
+        std::thread thread;
+        std::atomic<bool> finished{ false };
+    };
+
+    std::vector<std::unique_ptr<connection>> connections;
+
+    INFO("[Service] Listening on {}", address);
+
+    while(!g_stop_requested.load(std::memory_order_relaxed)) {
+        auto client = listener.accept(s_poll_interval_ms);
+
+        // the threads of clients that left
+        auto const gone = std::stable_partition(connections.begin(), connections.end(), [](auto const& c) {
+            return !c->finished.load(std::memory_order_acquire);
+        });
+        for(auto it = gone; it != connections.end(); ++it) {
+            (*it)->thread.join();
+        }
+        connections.erase(gone, connections.end());
+
+        if(!client.valid()) {
+            continue;
+        }
+
+        auto c = std::make_unique<connection>();
+        c->client = std::move(client);
+        c->thread = std::thread{ [this, c = c.get()] {
+            this->serve(c->client);
+            c->finished.store(true, std::memory_order_release);
+        } };
+        connections.push_back(std::move(c));
+    }
+
+    INFO("[Service] Stopping, {} clients connected", connections.size());
+
+    // clients waiting on a step get an error instead of waiting for it
+    {
+        std::lock_guard<std::mutex> const lock{ m_steps_mutex };
+        m_stop.store(true, std::memory_order_release);
+    }
+    m_steps_cv.notify_all();
+
+    // a client that's still waiting for an answer gets it, then finds nothing more to read
+    for(auto& c : connections) {
+        c->client.shutdown();
+        c->thread.join();
+    }
+
+    return true;
+}
+
+auto pack_cells(gol::board const& b, int const x0, int const y0, int const w, int const h) -> std::string
+{
+    constexpr int bits_per_byte = 8;
+    auto const row_size = static_cast<std::size_t>((w + bits_per_byte - 1) / bits_per_byte);
+    std::string bytes(row_size * static_cast<std::size_t>(h), '\0');
+
+    for(int y = 0; y < h; ++y) {
+        auto const* cells = b.row(y0 + y) + x0; // NOLINT
+        auto* out = &bytes[static_cast<std::size_t>(y) * row_size];
+
+        for(int x = 0; x < w; x += bits_per_byte) {
+            unsigned byte = 0;
+
+            for(int bit = 0; bit < std::min(bits_per_byte, w - x); ++bit) {
+                byte |= static_cast<unsigned>(cells[x + bit]) << static_cast<unsigned>(bit); // NOLINT
+            }
+
+            out[x / bits_per_byte] = static_cast<char>(byte); // NOLINT
+        }
+    }
+
+    return bytes;
+}
+
+} // namespace gol
@@ -0,0 +1,152 @@
+#ifndef GOL_SERVICE_HPP
+#define GOL_SERVICE_HPP
+#pragma once
+
+#include "socket.hpp"
+
+#include "engine/board.hpp"
+#include "engine/engine.hpp"
+#include "engine/rule.hpp"
+#include "thread/thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gol {
+
+// Hosts any number of simulations, called sessions, for clients on a local socket. Every client gets a thread that
+// reads commands, one per line, and answers `ok ...` or `error <why>`:
+//
+//     create <w> <h> [<rule> [bounded|torus]]  ok <session>
+//     load <session> <x> <y> <size>           then <size> bytes of a plaintext or RLE pattern, top left at (x, y),
+//                                             no bigger than the board
+//     step <session> <n> [<session> <n> ...]  ok <generation> for each, once every step is done. They're queued
+//                                             together, so they're stepped in the same batches.
+//     read <session> <x> <y> <w> <h>          ok <size> then <size> bytes, h rows of (w + 7) / 8 bytes each with
+//                                             cell x at bit x % 8 of byte x / 8
+//     hash <session>                          ok <FNV-1a hash of the cells>
+//     snapshot <session>                      ok <new session>, a copy of the board and its generation
+//     close <session>                         ok
+//     shutdown                                ok, and the service stops
+//
+// Any client can use any session. Steps from every client are stepped in batches on one shared thread pool, a
+// session per task, so many short requests share a single dispatch. A batch steps each session by about
+// s_slice_cells cell updates and the rest carries on in the next batch, but always by at least one generation: a
+// board bigger than that holds every other session in the batch for a whole generation of its own.
+class service
+{
+private:
+    static constexpr int s_poll_interval_ms = 100;
+    // cell updates a session gets per batch
+    static constexpr std::size_t s_slice_cells = std::size_t{ 1 } << 24U;
+
+    // bytes counted in a total against a limit, until it's destroyed
+    class reservation
+    {
+    private:
+        std::atomic<std::size_t>* m_total = nullptr;
+        std::size_t m_bytes = 0;
+
+    public:
+        reservation() noexcept = default;
+        reservation(reservation const&) = delete;
+        reservation(reservation&&) noexcept = delete;
+        ~reservation() noexcept;
+
+        auto operator=(reservation const&) -> reservation& = delete;
+        auto operator=(reservation&&) noexcept -> reservation& = delete;
+
+        // counts `bytes` in `total`, false and nothing counted if that would take it past `limit`, 0 for no limit
+        [[nodiscard]] auto reserve(std::atomic<std::size_t>& total, std::size_t bytes, std::size_t limit) noexcept
+            -> bool;
+    };
+
+    struct session
+    {
+        // held while the session is stepped, read or written
+        std::mutex mutex;
+        gol::board current;
+        gol::board next;
+        gol::sliding_engine engine;
+        long generation = 0;
+        // the boards' bytes, given back once the last step holding on to the session is done
+        reservation memory;
+    };
+
+    struct step_request
+    {
+        std::shared_ptr<session> target;
+        long remaining = 0;
+        // the session's generation once the last slice is stepped, -1 until the first one is
+        long generation = -1;
+        std::promise<long> done;
+    };
+
+    gol::rule m_rule{};
+    gol::topology m_topology = gol::topology::bounded;
+    std::size_t m_max_memory = 0;
+    // bytes of the boards of every session and of patterns being loaded, before the sessions so it outlives them
+    std::atomic<std::size_t> m_session_memory{ 0 };
+
+    std::mutex m_sessions_mutex;
+    std::map<long, std::shared_ptr<session>> m_sessions;
+    long m_next_session = 1;
+
+    std::mutex m_steps_mutex;
+    std::condition_variable m_steps_cv;
+    std::vector<step_request> m_steps;
+    gol::threadpool m_threadpool;
+    std::thread m_stepper;
+
+    std::atomic<bool> m_stop{ false };
+
+    [[nodiscard]] auto find(long id) -> std::shared_ptr<session>;
+    [[nodiscard]] auto add(std::shared_ptr<session> s) -> long;
+    // a session with `w` x `h` boards counted against m_max_memory, nullptr if there isn't room for it
+    [[nodiscard]] auto make_session(int w, int h) -> std::shared_ptr<session>;
+    auto serve(gol::socket const& client) -> void;
+    // the stepper thread's loop, runs until m_stop
+    auto step_batches() -> void;
+    // steps `r` by s_slice_cells cell updates or a single generation, whichever is more, on a worker of m_threadpool
+    static auto step_slice(step_request& r) -> void;
+
+public:
+    // Sessions get `r` and `t` unless they're created with their own, `num_threads` steps them. Creating a session or
+    // loading a pattern fails once the boards of all of them and the patterns would take more than `max_memory`
+    // bytes, 0 for no limit.
+    service(gol::rule const& r, gol::topology t, std::size_t num_threads, std::size_t max_memory = 0);
+    service(service const&) = delete;
+    service(service&&) noexcept = delete;
+    ~service() noexcept;
+
+    auto operator=(service const&) -> service& = delete;
+    auto operator=(service&&) noexcept -> service& = delete;
+
+    // serves clients on a port of 127.0.0.1 or a Unix domain socket path until `shutdown` or request_stop(), false
+    // if `address` can't be listened on
+    auto run(std::string const& address) -> bool;
+
+    // The answer to one command line. `load` reads its pattern from `client`, starting with what's left in `buffered`
+    // from the previous line.
+    [[nodiscard]] auto execute(std::string const& line, gol::socket const& client, std::string& buffered)
+        -> std::string;
+
+    // Only touches a lock-free atomic, so it's safe to call from a signal handler
+    static auto request_stop() noexcept -> void;
+};
+
+// the `w` x `h` cells at (x, y) as `read` sends them: rows of (w + 7) / 8 bytes, cell x at bit x % 8 of byte x / 8
+[[nodiscard]] auto pack_cells(gol::board const& b, int x, int y, int w, int h) -> std::string;
+
+} // namespace gol
+
+#endif // !GOL_SERVICE_HPP
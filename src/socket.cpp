@@ -0,0 +1,270 @@
+#include "socket.hpp"
+
+#include "log.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace gol {
+
+socket::socket(int const fd) noexcept
+    : m_fd{ fd }
+{
+}
+
+socket::socket(socket&& other) noexcept
+    : m_fd{ std::exchange(other.m_fd, -1) }
+    , m_path{ std::move(other.m_path) }
+{
+}
+
+socket::~socket() noexcept
+{
+    this->close();
+}
+
+auto socket::operator=(socket&& other) noexcept -> socket&
+{
+    if(this != &other) {
+        this->close();
+        m_fd = std::exchange(other.m_fd, -1);
+        m_path = std::move(other.m_path);
+    }
+
+    return *this;
+}
+
+auto socket::valid() const noexcept -> bool
+{
+    return m_fd >= 0;
+}
+
+#ifndef _WIN32
+
+auto socket::close() noexcept -> void
+{
+    if(m_fd < 0) {
+        return;
+    }
+
+    ::close(m_fd);
+    m_fd = -1;
+
+    if(!m_path.empty()) {
+        ::unlink(m_path.c_str());
+        m_path.clear();
+    }
+}
+
+auto socket::shutdown() const noexcept -> void
+{
+    if(m_fd >= 0) {
+        ::shutdown(m_fd, SHUT_RD);
+    }
+}
+
+auto socket::accept(int const timeout_ms) const noexcept -> socket
+{
+    pollfd p{};
+    p.fd = m_fd;
+    p.events = POLLIN;
+
+    if(::poll(&p, 1, timeout_ms) <= 0) {
+        return socket{};
+    }
+
+    return socket{ ::accept(m_fd, nullptr, nullptr) };
+}
+
+auto socket::send(void const* data, std::size_t size) const noexcept -> bool
+{
+    auto const* bytes = static_cast<char const*>(data);
+
+    while(size > 0) {
+        // a client going away mustn't kill the process with SIGPIPE
+#ifdef MSG_NOSIGNAL
+        auto const sent = ::send(m_fd, bytes, size, MSG_NOSIGNAL);
+#else
+        auto const sent = ::send(m_fd, bytes, size, 0);
+#endif
+
+        if(sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if(sent <= 0) {
+            return false;
+        }
+
+        bytes += sent; // NOLINT
+        size -= static_cast<std::size_t>(sent);
+    }
+
+    return true;
+}
+
+auto socket::receive(void* data, std::size_t const size) const noexcept -> std::size_t
+{
+    for(;;) {
+        auto const received = ::recv(m_fd, data, size, 0);
+
+        if(received < 0 && errno == EINTR) {
+            continue;
+        }
+
+        return received > 0 ? static_cast<std::size_t>(received) : 0;
+    }
+}
+
+auto socket::set_receive_timeout(int const timeout_ms) const noexcept -> void
+{
+    constexpr int ms_per_s = 1000;
+    constexpr int us_per_ms = 1000;
+
+    timeval t{};
+    t.tv_sec = timeout_ms / ms_per_s;
+    t.tv_usec = (timeout_ms % ms_per_s) * us_per_ms;
+    ::setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &t, sizeof(t));
+}
+
+auto listen_local(std::string const& address) -> socket
+{
+    constexpr int backlog = 16;
+    constexpr std::size_t max_port_digits = 5;
+    constexpr unsigned long max_port = 65535;
+
+    bool const is_port = !address.empty() && address.size() <= max_port_digits &&
+                         std::all_of(address.begin(), address.end(), [](char const c) { return c >= '0' && c <= '9'; });
+
+    if(is_port) {
+        auto const port = std::stoul(address);
+        if(port > max_port) {
+            return socket{};
+        }
+
+        socket s{ ::socket(AF_INET, SOCK_STREAM, 0) };
+        if(!s.valid()) {
+            return s;
+        }
+
+        int const reuse = 1;
+        ::setsockopt(s.m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_port = htons(static_cast<std::uint16_t>(port));
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if(::bind(s.m_fd, reinterpret_cast<sockaddr const*>(&a), sizeof(a)) != 0 || // NOLINT
+           ::listen(s.m_fd, backlog) != 0) {
+            return socket{};
+        }
+
+        return s;
+    }
+
+    sockaddr_un a{};
+    if(address.empty() || address.size() >= sizeof(a.sun_path)) {
+        return socket{};
+    }
+
+    a.sun_family = AF_UNIX;
+    std::memcpy(a.sun_path, address.c_str(), address.size() + 1); // NOLINT
+
+    // a socket left behind by a run that didn't get to clean up refuses connections and is replaced, one that's
+    // listened on and anything else are left alone
+    struct stat existing; // NOLINT
+    if(::lstat(address.c_str(), &existing) == 0) {
+        if(!S_ISSOCK(existing.st_mode)) { // NOLINT
+            ERROR("{} already exists and isn't a socket", address);
+            return socket{};
+        }
+
+        socket const probe{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+        if(!probe.valid()) {
+            return socket{};
+        }
+
+        if(::connect(probe.m_fd, reinterpret_cast<sockaddr const*>(&a), sizeof(a)) == 0) { // NOLINT
+            ERROR("{} is already being listened on", address);
+            return socket{};
+        }
+
+        if(errno != ECONNREFUSED) {
+            ERROR("Could not tell whether {} is still in use: {}", address, std::strerror(errno));
+            return socket{};
+        }
+
+        ::unlink(address.c_str());
+    }
+
+    socket s{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+    if(!s.valid()) {
+        return s;
+    }
+
+    if(::bind(s.m_fd, reinterpret_cast<sockaddr const*>(&a), sizeof(a)) != 0 || // NOLINT
+       ::listen(s.m_fd, backlog) != 0) {
+        return socket{};
+    }
+
+    s.m_path = address;
+    return s;
+}
+
+#else
+
+auto socket::close() noexcept -> void
+{
+    m_fd = -1;
+}
+
+auto socket::shutdown() const noexcept -> void
+{
+}
+
+auto socket::accept([[maybe_unused]] int const timeout_ms) const noexcept -> socket
+{
+    return socket{};
+}
+
+auto socket::send([[maybe_unused]] void const* data, [[maybe_unused]] std::size_t const size) const noexcept -> bool
+{
+    return false;
+}
+
+auto socket::receive([[maybe_unused]] void* data, [[maybe_unused]] std::size_t const size) const noexcept
+    -> std::size_t
+{
+    return 0;
+}
+
+auto socket::set_receive_timeout([[maybe_unused]] int const timeout_ms) const noexcept -> void
+{
+}
+
+auto listen_local([[maybe_unused]] std::string const& address) -> socket
+{
+    return socket{};
+}
+
+#endif
+
+auto socket::send(std::string_view const text) const noexcept -> bool
+{
+    return this->send(text.data(), text.size());
+}
+
+} // namespace gol
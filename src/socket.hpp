@@ -0,0 +1,57 @@
+#ifndef GOL_SOCKET_HPP
+#define GOL_SOCKET_HPP
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace gol {
+
+// Owns a stream socket, either listening or connected. Only implemented on POSIX systems, elsewhere every socket is
+// invalid.
+class socket
+{
+private:
+    int m_fd = -1;
+    // the file a listening Unix domain socket is bound to, removed on close
+    std::string m_path;
+
+    friend auto listen_local(std::string const& address) -> socket;
+
+public:
+    socket() noexcept = default;
+    socket(socket const&) = delete;
+    socket(socket&& other) noexcept;
+    ~socket() noexcept;
+
+    explicit socket(int fd) noexcept;
+
+    auto operator=(socket const&) -> socket& = delete;
+    auto operator=(socket&& other) noexcept -> socket&;
+
+    [[nodiscard]] auto valid() const noexcept -> bool;
+    auto close() noexcept -> void;
+    // wakes up a receive() blocked on another thread, it returns 0 from then on. Sending still works.
+    auto shutdown() const noexcept -> void;
+
+    // waits up to `timeout_ms` for a client, an invalid socket if none came
+    [[nodiscard]] auto accept(int timeout_ms) const noexcept -> socket;
+
+    // false once the peer is gone
+    auto send(void const* data, std::size_t size) const noexcept -> bool;
+    auto send(std::string_view text) const noexcept -> bool;
+    // up to `size` bytes, 0 once the peer is gone
+    [[nodiscard]] auto receive(void* data, std::size_t size) const noexcept -> std::size_t;
+    // a receive() that has nothing after `timeout_ms` returns 0
+    auto set_receive_timeout(int timeout_ms) const noexcept -> void;
+};
+
+// A port number listens on 127.0.0.1, anything else is the path of a Unix domain socket. A socket file there that
+// refuses connections was left behind and is replaced, one that's listened on or another kind of file is an error.
+// Invalid on failure.
+[[nodiscard]] auto listen_local(std::string const& address) -> socket;
+
+} // namespace gol
+
+#endif // !GOL_SOCKET_HPP
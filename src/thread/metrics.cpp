@@ -0,0 +1,121 @@
+#include "metrics.hpp"
+
+#include <stdexcept>
+
+namespace gol {
+
+auto metrics::get() noexcept -> metrics&
+{
+    static metrics inst;
+    return inst;
+}
+
+auto metrics::local_shard() -> shard&
+{
+    thread_local shard* local = nullptr;
+
+    if(local == nullptr) {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_shards.push_back(std::make_unique<shard>());
+        local = m_shards.back().get();
+    }
+
+    return *local;
+}
+
+auto metrics::add(char const* name, char const* help, metric_kind const kind, double const scale) -> std::size_t
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    if(m_infos.size() == s_max_metrics) {
+        throw std::length_error{ "Too many metrics, raise metrics::s_max_metrics" };
+    }
+
+    m_infos.push_back({ name, help, kind, scale });
+    return m_infos.size() - 1;
+}
+
+auto metrics::increment(std::size_t const id, std::int64_t const n) noexcept -> void
+{
+    // only this thread writes its shard, no need for a read-modify-write
+    auto& v = this->local_shard().values[id];
+    v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+auto metrics::set(std::size_t const id, std::int64_t const value) noexcept -> void
+{
+    m_gauges[id].value.store(value, std::memory_order_relaxed);
+}
+
+auto metrics::move(std::size_t const id, std::int64_t const delta) noexcept -> void
+{
+    m_gauges[id].value.fetch_add(delta, std::memory_order_relaxed);
+}
+
+auto metrics::value(std::size_t const id) -> std::int64_t
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    if(m_infos[id].kind == metric_kind::gauge) {
+        return m_gauges[id].value.load(std::memory_order_relaxed);
+    }
+
+    std::int64_t sum = 0;
+    for(auto const& s : m_shards) {
+        sum += s->values[id].load(std::memory_order_relaxed);
+    }
+
+    return sum;
+}
+
+auto metrics::write(std::ostream& out) -> void
+{
+    std::vector<info> infos;
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        infos = m_infos;
+    }
+
+    for(std::size_t id = 0; id < infos.size(); ++id) {
+        auto const& i = infos[id];
+        auto const v = this->value(id);
+
+        out << "# HELP " << i.name << ' ' << i.help << '\n';
+        out << "# TYPE " << i.name << (i.kind == metric_kind::counter ? " counter\n" : " gauge\n");
+        out << i.name << ' ';
+
+        if(i.scale == 1.0) {
+            out << v << '\n';
+        }
+        else {
+            out << static_cast<double>(v) * i.scale << '\n';
+        }
+    }
+}
+
+metric::metric(char const* name, char const* help, metric_kind const kind, double const scale)
+    : m_id{ metrics::get().add(name, help, kind, scale) }
+{
+}
+
+auto metric::increment(std::int64_t const n) noexcept -> void
+{
+    metrics::get().increment(m_id, n);
+}
+
+auto metric::set(std::int64_t const value) noexcept -> void
+{
+    metrics::get().set(m_id, value);
+}
+
+auto metric::move(std::int64_t const delta) noexcept -> void
+{
+    metrics::get().move(m_id, delta);
+}
+
+auto metric::value() const -> std::int64_t
+{
+    return metrics::get().value(m_id);
+}
+
+} // namespace gol
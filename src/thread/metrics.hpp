@@ -0,0 +1,105 @@
+#ifndef GOL_THREAD_METRICS_HPP
+#define GOL_THREAD_METRICS_HPP
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace gol {
+
+enum class metric_kind
+{
+    // only goes up, every thread adds to its own copy and a scrape sums them
+    counter,
+    // a single value set by its owner, or moved up and down by several threads
+    gauge
+};
+
+// Process wide registry of the metrics declared with gol::metric, written out in the Prometheus text format
+class metrics
+{
+private:
+    static constexpr std::size_t s_cache_line = 64;
+    static constexpr std::size_t s_max_metrics = 32;
+
+    struct info
+    {
+        char const* name = nullptr;
+        char const* help = nullptr;
+        metric_kind kind = metric_kind::counter;
+        double scale = 1.0;
+    };
+
+    // the counters of one thread, nobody else writes to its cache lines
+    struct alignas(s_cache_line) shard
+    {
+        std::array<std::atomic<std::int64_t>, s_max_metrics> values{};
+    };
+
+    struct alignas(s_cache_line) gauge_value
+    {
+        std::atomic<std::int64_t> value{ 0 };
+    };
+
+    // only guards registering metrics and per-thread shards, recording never takes it
+    std::mutex m_mutex;
+    std::vector<info> m_infos;
+    std::vector<std::unique_ptr<shard>> m_shards;
+    std::array<gauge_value, s_max_metrics> m_gauges{};
+
+    metrics() = default;
+
+    [[nodiscard]] auto local_shard() -> shard&;
+
+public:
+    metrics(metrics const&) = delete;
+    metrics(metrics&&) noexcept = delete;
+    ~metrics() noexcept = default;
+
+    auto operator=(metrics const&) -> metrics& = delete;
+    auto operator=(metrics&&) noexcept -> metrics& = delete;
+
+    [[nodiscard]] static auto get() noexcept -> metrics&;
+
+    // the id of the new metric, throws std::length_error once there are s_max_metrics
+    [[nodiscard]] auto add(char const* name, char const* help, metric_kind kind, double scale) -> std::size_t;
+
+    auto increment(std::size_t id, std::int64_t n) noexcept -> void;
+    auto set(std::size_t id, std::int64_t value) noexcept -> void;
+    auto move(std::size_t id, std::int64_t delta) noexcept -> void;
+    // a counter summed over every thread, or a gauge's value
+    [[nodiscard]] auto value(std::size_t id) -> std::int64_t;
+
+    // every metric with its HELP and TYPE lines
+    auto write(std::ostream& out) -> void;
+};
+
+// Declared once per metric, usually at namespace scope next to the code that updates it
+class metric
+{
+private:
+    std::size_t m_id = 0;
+
+public:
+    // `name` and `help` must outlive the metric, in practice string literals. Values are multiplied by `scale` when
+    // written out, so they can be kept as integers (nanoseconds with a scale of 1e-9 show up as seconds).
+    metric(char const* name, char const* help, metric_kind kind, double scale = 1.0);
+
+    // counters
+    auto increment(std::int64_t n = 1) noexcept -> void;
+    // gauges
+    auto set(std::int64_t value) noexcept -> void;
+    auto move(std::int64_t delta) noexcept -> void;
+
+    [[nodiscard]] auto value() const -> std::int64_t;
+};
+
+} // namespace gol
+
+#endif // !GOL_THREAD_METRICS_HPP
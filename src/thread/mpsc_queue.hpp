@@ -0,0 +1,91 @@
+#ifndef GOL_THREAD_MPSC_QUEUE_HPP
+#define GOL_THREAD_MPSC_QUEUE_HPP
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace gol {
+
+// Bounded lock-free queue for many producers and one consumer. A slot's sequence
+// number says whether it's free for a producer (seq == pos) or ready to pop (seq == pos + 1).
+template<typename T, std::size_t N>
+class mpsc_queue
+{
+private:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "mpsc_queue size must be a power of two");
+
+    static constexpr std::size_t s_mask = N - 1;
+
+    struct slot
+    {
+        std::atomic<std::size_t> seq{ 0 };
+        T value{};
+    };
+
+    std::array<slot, N> m_slots;
+    std::atomic<std::size_t> m_head{ 0 };
+    std::size_t m_tail{ 0 };
+
+public:
+    mpsc_queue() noexcept
+    {
+        for(std::size_t i = 0; i < N; ++i) {
+            m_slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpsc_queue(mpsc_queue const&) = delete;
+    mpsc_queue(mpsc_queue&&) noexcept = delete;
+    ~mpsc_queue() noexcept = default;
+
+    auto operator=(mpsc_queue const&) -> mpsc_queue& = delete;
+    auto operator=(mpsc_queue&&) noexcept -> mpsc_queue& = delete;
+
+    auto push(T const& value) -> bool
+    {
+        std::size_t pos = m_head.load(std::memory_order_relaxed);
+
+        for(;;) {
+            slot& s = m_slots[pos & s_mask];
+            std::size_t const seq = s.seq.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if(diff == 0) {
+                if(m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    s.value = value;
+                    s.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            // queue full
+            else if(diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    auto pop(T& value) -> bool
+    {
+        slot& s = m_slots[m_tail & s_mask];
+
+        // queue empty (or the producer owning this slot hasn't finished writing yet)
+        if(s.seq.load(std::memory_order_acquire) != m_tail + 1) {
+            return false;
+        }
+
+        value = std::move(s.value);
+        s.seq.store(m_tail + N, std::memory_order_release);
+        ++m_tail;
+        return true;
+    }
+};
+
+} // namespace gol
+
+#endif // !GOL_THREAD_MPSC_QUEUE_HPP
@@ -4,65 +4,200 @@
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 namespace gol {
 
+// Single producer, single consumer queue holding at most N - 1 elements. Elements are moved in and out of storage
+// that lives inside the buffer, so nothing is allocated after construction. The blocking variants spin for a bit and
+// then sleep until the other side makes progress, the other side only pays for waking them up when someone is asleep.
 template<typename T, std::size_t N>
 class ring_buffer
 {
 private:
-    std::array<T, N> m_ring;
-    std::atomic<std::size_t> m_head;
-    std::atomic<std::size_t> m_tail;
+    static constexpr std::size_t s_cache_line = 64;
+    static constexpr int s_spin_count = 64;
+
+    using storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+    // written by the producer, m_cached_tail is its last look at m_tail
+    alignas(s_cache_line) std::atomic<std::size_t> m_head{ 0 };
+    std::size_t m_cached_tail = 0;
+    // written by the consumer, m_cached_head is its last look at m_head
+    alignas(s_cache_line) std::atomic<std::size_t> m_tail{ 0 };
+    std::size_t m_cached_head = 0;
+
+    alignas(s_cache_line) std::atomic<int> m_waiters{ 0 };
+    std::atomic<bool> m_closed{ false };
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+    std::array<storage, N> m_ring;
 
     [[nodiscard]] static auto next(std::size_t current) noexcept -> std::size_t
     {
         return (current + 1) % N;
     }
 
-public:
-    ring_buffer()
-        : m_head{ 0 }
-        , m_tail{ 0 }
+    [[nodiscard]] auto slot(std::size_t const i) noexcept -> T*
+    {
+        return std::launder(reinterpret_cast<T*>(&m_ring[i])); // NOLINT
+    }
+
+    [[nodiscard]] auto full() noexcept -> bool
     {
+        auto const next_head = next(m_head.load(std::memory_order_relaxed));
+
+        if(next_head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+        }
+
+        return next_head == m_cached_tail;
     }
 
-    ring_buffer(ring_buffer const&) = default;
-    ring_buffer(ring_buffer&&) noexcept = default;
-    ~ring_buffer() noexcept = default;
+    [[nodiscard]] auto empty() noexcept -> bool
+    {
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+
+        if(tail == m_cached_head) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+        }
 
-    auto operator=(ring_buffer const&) -> ring_buffer& = default;
-    auto operator=(ring_buffer&&) noexcept -> ring_buffer& = default;
+        return tail == m_cached_head;
+    }
 
-    auto push(T const& value) -> bool
+    auto wake() -> void
     {
-        std::size_t head = m_head.load(std::memory_order_relaxed);
-        std::size_t next_head = next(head);
+        // pairs with the increment of m_waiters: either the waiter sees the new index or we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(m_waiters.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> const lock{ m_mutex };
+            m_cv.notify_all();
+        }
+    }
+
+    // returns false if the buffer was closed before `ready` became true
+    template<typename Predicate>
+    auto wait(Predicate ready) -> bool
+    {
+        for(int i = 0; i < s_spin_count; ++i) {
+            if(ready()) {
+                return true;
+            }
+            if(m_closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        m_waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_cv.wait(lock, [this, &ready] { return ready() || m_closed.load(std::memory_order_acquire); });
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+        return ready();
+    }
+
+public:
+    ring_buffer() noexcept = default;
+    ring_buffer(ring_buffer const&) = delete;
+    ring_buffer(ring_buffer&&) noexcept = delete;
+
+    ~ring_buffer() noexcept
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        auto const head = m_head.load(std::memory_order_relaxed);
+
+        for(; tail != head; tail = next(tail)) {
+            this->slot(tail)->~T();
+        }
+    }
 
-        // buffer full
-        if(next_head == m_tail.load(std::memory_order_acquire)) {
+    auto operator=(ring_buffer const&) -> ring_buffer& = delete;
+    auto operator=(ring_buffer&&) noexcept -> ring_buffer& = delete;
+
+    template<typename... Args>
+    auto try_emplace(Args&&... args) -> bool
+    {
+        if(this->full()) {
             return false;
         }
 
-        m_ring.at(head) = value;
-        m_head.store(next_head, std::memory_order_release);
+        auto const head = m_head.load(std::memory_order_relaxed);
+        new(&m_ring[head]) T(std::forward<Args>(args)...);
+        m_head.store(next(head), std::memory_order_release);
+        this->wake();
+
         return true;
     }
 
-    auto pop(T& value) -> bool
+    auto try_push(T&& value) -> bool
     {
-        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        return this->try_emplace(std::move(value));
+    }
+
+    auto try_push(T const& value) -> bool
+    {
+        return this->try_emplace(value);
+    }
 
-        // buffer empty
-        if(tail == m_head.load(std::memory_order_acquire)) {
+    auto try_pop(T& value) -> bool
+    {
+        if(this->empty()) {
             return false;
         }
 
-        value = std::move(m_ring.at(tail));
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+        auto* element = this->slot(tail);
+
+        value = std::move(*element);
+        element->~T();
         m_tail.store(next(tail), std::memory_order_release);
+        this->wake();
+
         return true;
     }
+
+    // waits for a free slot, false if the buffer was closed first
+    template<typename... Args>
+    auto emplace(Args&&... args) -> bool
+    {
+        if(!this->wait([this] { return !this->full(); })) {
+            return false;
+        }
+
+        return this->try_emplace(std::forward<Args>(args)...);
+    }
+
+    auto push(T&& value) -> bool
+    {
+        return this->emplace(std::move(value));
+    }
+
+    // waits for an element, false if the buffer was closed while empty
+    auto pop(T& value) -> bool
+    {
+        if(!this->wait([this] { return !this->empty(); })) {
+            return false;
+        }
+
+        return this->try_pop(value);
+    }
+
+    // wakes up everyone blocked, from now on blocking calls fail instead of waiting. What's inside can still be popped.
+    auto close() -> void
+    {
+        m_closed.store(true, std::memory_order_release);
+
+        std::lock_guard<std::mutex> const lock{ m_mutex };
+        m_cv.notify_all();
+    }
 };
 
 } // namespace gol
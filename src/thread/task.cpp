@@ -0,0 +1,89 @@
+#include "task.hpp"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Free list of fixed size blocks carved out of bigger chunks that are never given back
+class slab
+{
+private:
+    static constexpr std::size_t s_blocks_per_chunk = 64;
+
+    struct block
+    {
+        block* next;
+    };
+
+    std::mutex m_mutex;
+    block* m_free = nullptr;
+    std::vector<std::unique_ptr<unsigned char[]>> m_chunks;
+
+public:
+    [[nodiscard]] static auto get() -> slab&
+    {
+        static slab inst;
+        return inst;
+    }
+
+    [[nodiscard]] auto allocate() -> void*
+    {
+        std::lock_guard<std::mutex> const lock{ m_mutex };
+
+        if(m_free == nullptr) {
+            auto& chunk = m_chunks.emplace_back(new unsigned char[gol::task::s_slab_block_size * s_blocks_per_chunk]);
+
+            for(std::size_t i = 0; i < s_blocks_per_chunk; ++i) {
+                void* memory = &chunk[i * gol::task::s_slab_block_size];
+                m_free = ::new(memory) block{ m_free };
+            }
+        }
+
+        return std::exchange(m_free, m_free->next);
+    }
+
+    auto deallocate(void* ptr) noexcept -> void
+    {
+        std::lock_guard<std::mutex> const lock{ m_mutex };
+        m_free = ::new(ptr) block{ m_free };
+    }
+
+    [[nodiscard]] auto refills() noexcept -> std::size_t
+    {
+        std::lock_guard<std::mutex> const lock{ m_mutex };
+        return m_chunks.size();
+    }
+};
+
+} // namespace
+
+namespace gol {
+
+auto task::allocate(std::size_t const size) -> void*
+{
+    if(size > s_slab_block_size) {
+        return ::operator new(size);
+    }
+
+    return slab::get().allocate();
+}
+
+auto task::deallocate(void* ptr, std::size_t const size) noexcept -> void
+{
+    if(size > s_slab_block_size) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    slab::get().deallocate(ptr);
+}
+
+auto task::slab_refills() noexcept -> std::size_t
+{
+    return slab::get().refills();
+}
+
+} // namespace gol
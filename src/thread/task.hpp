@@ -0,0 +1,175 @@
+#ifndef GOL_THREAD_TASK_HPP
+#define GOL_THREAD_TASK_HPP
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace gol {
+
+// Move-only `void()` callable. Anything up to s_inline_size bytes lives inside the task itself, bigger ones come
+// from a slab of recycled blocks, so in steady state creating and running tasks doesn't touch the heap.
+class task
+{
+private:
+    static constexpr std::size_t s_inline_size = 64;
+
+    struct operations
+    {
+        void (*invoke)(void* storage);
+        // moves the callable in `from` to the uninitialized `to` and destroys what's left in `from`
+        void (*relocate)(void* from, void* to) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template<typename F>
+    static constexpr bool s_fits_inline = sizeof(F) <= s_inline_size && alignof(F) <= alignof(std::max_align_t) &&
+                                          std::is_nothrow_move_constructible_v<F>;
+
+    template<typename F>
+    struct inline_operations
+    {
+        static auto invoke(void* storage) -> void
+        {
+            (*std::launder(static_cast<F*>(storage)))();
+        }
+
+        static auto relocate(void* from, void* to) noexcept -> void
+        {
+            auto* f = std::launder(static_cast<F*>(from));
+            ::new(to) F(std::move(*f));
+            f->~F();
+        }
+
+        static auto destroy(void* storage) noexcept -> void
+        {
+            std::launder(static_cast<F*>(storage))->~F();
+        }
+
+        static constexpr operations s_operations = { invoke, relocate, destroy };
+    };
+
+    // the storage holds a pointer to the callable
+    template<typename F>
+    struct boxed_operations
+    {
+        [[nodiscard]] static auto box(void* storage) noexcept -> F*&
+        {
+            return *std::launder(static_cast<F**>(storage));
+        }
+
+        static auto invoke(void* storage) -> void
+        {
+            (*box(storage))();
+        }
+
+        static auto relocate(void* from, void* to) noexcept -> void
+        {
+            ::new(to) F*(box(from));
+        }
+
+        static auto destroy(void* storage) noexcept -> void
+        {
+            F* f = box(storage);
+            f->~F();
+            deallocate(f, sizeof(F));
+        }
+
+        static constexpr operations s_operations = { invoke, relocate, destroy };
+    };
+
+    alignas(std::max_align_t) unsigned char m_storage[s_inline_size]; // NOLINT
+    operations const* m_operations = nullptr;
+
+    auto reset() noexcept -> void
+    {
+        if(m_operations != nullptr) {
+            m_operations->destroy(m_storage);
+            m_operations = nullptr;
+        }
+    }
+
+public:
+    static constexpr std::size_t s_slab_block_size = 256;
+
+    // blocks of s_slab_block_size bytes are recycled, bigger sizes go straight to the heap
+    [[nodiscard]] static auto allocate(std::size_t size) -> void*;
+    static auto deallocate(void* ptr, std::size_t size) noexcept -> void;
+    // how many times the slab had to ask the heap for memory, for benchmarks
+    [[nodiscard]] static auto slab_refills() noexcept -> std::size_t;
+
+    task() noexcept = default;
+    task(task const&) = delete;
+
+    task(task&& other) noexcept
+        : m_operations{ std::exchange(other.m_operations, nullptr) }
+    {
+        if(m_operations != nullptr) {
+            m_operations->relocate(other.m_storage, m_storage);
+        }
+    }
+
+    template<typename F,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, task> && std::is_invocable_v<F&>>>
+    task(F&& f) // NOLINT(google-explicit-constructor)
+    {
+        using function = std::decay_t<F>;
+
+        if constexpr(s_fits_inline<function>) {
+            ::new(static_cast<void*>(m_storage)) function(std::forward<F>(f));
+            m_operations = &inline_operations<function>::s_operations;
+        }
+        else {
+            static_assert(alignof(function) <= alignof(std::max_align_t), "Over-aligned tasks aren't supported");
+
+            void* memory = allocate(sizeof(function));
+
+            try {
+                ::new(static_cast<void*>(m_storage)) function*(::new(memory) function(std::forward<F>(f)));
+            }
+            catch(...) {
+                deallocate(memory, sizeof(function));
+                throw;
+            }
+
+            m_operations = &boxed_operations<function>::s_operations;
+        }
+    }
+
+    ~task() noexcept
+    {
+        this->reset();
+    }
+
+    auto operator=(task const&) -> task& = delete;
+
+    auto operator=(task&& other) noexcept -> task&
+    {
+        if(this != &other) {
+            this->reset();
+            m_operations = std::exchange(other.m_operations, nullptr);
+
+            if(m_operations != nullptr) {
+                m_operations->relocate(other.m_storage, m_storage);
+            }
+        }
+
+        return *this;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_operations != nullptr;
+    }
+
+    auto operator()() -> void
+    {
+        m_operations->invoke(m_storage);
+    }
+};
+
+} // namespace gol
+
+#endif // !GOL_THREAD_TASK_HPP
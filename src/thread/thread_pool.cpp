@@ -1,29 +1,78 @@
 #include "thread_pool.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+thread_local std::size_t g_current_worker = gol::threadpool::s_not_a_worker;
+
+gol::metric g_queued_tasks{ "gol_threadpool_queued_tasks",
+                            "Tasks waiting for a worker, over every thread pool",
+                            gol::metric_kind::gauge };
+
+auto pin_to_cpu(std::thread& thread, std::size_t const cpu) noexcept -> void
+{
+#ifdef _WIN32
+    SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << (cpu % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    static_cast<void>(thread);
+    static_cast<void>(cpu);
+#endif
+}
+
+} // namespace
 
 namespace gol {
 
 threadpool::threadpool(std::size_t const num_threads)
+    : threadpool{ num_threads, false }
+{
+}
+
+threadpool::threadpool(std::size_t const num_threads, bool const pin_threads)
 {
     m_workers.reserve(num_threads);
 
+    auto const num_cpus = std::max(1U, std::thread::hardware_concurrency());
+
     for(std::size_t i = 0; i < num_threads; ++i) {
-        m_workers.emplace_back([this]() -> void {
+        m_workers.emplace_back([this, i]() -> void {
+            g_current_worker = i;
+
             for(;;) {
-                std::function<void()> task{};
+                gol::task task{};
                 {
                     std::unique_lock<std::mutex> lock{ m_mutex };
-                    m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                    m_cv.wait(lock, [this] { return m_stop || m_num_tasks != 0; });
 
-                    if(m_stop && m_tasks.empty()) {
+                    if(m_stop && m_num_tasks == 0) {
                         return;
                     }
 
-                    task = std::move(m_tasks.front());
-                    m_tasks.pop();
+                    task = this->dequeue();
                 }
+
+                gol::trace_span const span{ "threadpool task" };
                 task();
             }
         });
+
+        if(pin_threads) {
+            pin_to_cpu(m_workers.back(), i % num_cpus);
+        }
     }
 }
 
@@ -41,4 +90,88 @@ threadpool::~threadpool() noexcept
     }
 }
 
+auto threadpool::enqueue(gol::task t) -> void
+{
+    {
+        std::unique_lock<std::mutex> lock{ m_mutex };
+
+        if(m_stop) {
+            throw std::runtime_error{ "Attempted to push to a terminated thread pool!" };
+        }
+
+        if(m_num_tasks == m_tasks.size()) {
+            constexpr std::size_t min_capacity = 64;
+            std::vector<gol::task> grown(std::max(min_capacity, m_tasks.size() * 2));
+
+            for(std::size_t i = 0; i < m_num_tasks; ++i) {
+                grown[i] = std::move(m_tasks[(m_first_task + i) % m_tasks.size()]);
+            }
+
+            m_tasks = std::move(grown);
+            m_first_task = 0;
+        }
+
+        m_tasks[(m_first_task + m_num_tasks) % m_tasks.size()] = std::move(t);
+        ++m_num_tasks;
+        g_queued_tasks.move(1);
+    }
+
+    m_cv.notify_one();
+}
+
+auto threadpool::dequeue() noexcept -> gol::task
+{
+    gol::task t = std::move(m_tasks[m_first_task]);
+    m_first_task = (m_first_task + 1) % m_tasks.size();
+    --m_num_tasks;
+    g_queued_tasks.move(-1);
+
+    return t;
+}
+
+auto threadpool::size() const noexcept -> std::size_t
+{
+    return m_workers.size();
+}
+
+auto threadpool::current_worker() noexcept -> std::size_t
+{
+    return g_current_worker;
+}
+
+task_group::task_group(threadpool& pool) noexcept
+    : m_pool{ pool }
+{
+}
+
+task_group::~task_group() noexcept
+{
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_cv.wait(lock, [this] { return m_pending == 0; });
+}
+
+// under the lock so the group can't be gone before the last task is done with it
+auto task_group::finish(std::exception_ptr error) noexcept -> void
+{
+    std::lock_guard<std::mutex> const lock{ m_mutex };
+
+    if(error != nullptr && m_error == nullptr) {
+        m_error = std::move(error);
+    }
+
+    if(--m_pending == 0) {
+        m_cv.notify_all();
+    }
+}
+
+auto task_group::wait() -> void
+{
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_cv.wait(lock, [this] { return m_pending == 0; });
+
+    if(m_error != nullptr) {
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+}
+
 } // namespace gol
@@ -2,34 +2,64 @@
 #define GOL_THREAD_THREADPOOL_HPP
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <stdexcept>
 #include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "task.hpp"
+
 namespace gol {
 
+enum class schedule
+{
+    // contiguous chunks, chunk i goes to worker i whenever it's free to take it so the same worker keeps touching
+    // the same memory from one call to the next
+    static_chunks,
+    // workers grab `grain` sized chunks until there are none left
+    dynamic_chunks
+};
+
+class task_group;
+
 class threadpool
 {
 private:
     std::vector<std::thread> m_workers;
-    std::queue<std::function<void()>> m_tasks;
+    // circular, grows to the most tasks ever queued at once and stays there
+    std::vector<gol::task> m_tasks;
+    std::size_t m_first_task = 0;
+    std::size_t m_num_tasks = 0;
     std::mutex m_mutex;
     std::condition_variable m_cv;
     bool m_stop{ false };
 
+    friend class task_group;
+
+    auto enqueue(gol::task t) -> void;
+    // m_mutex must be held
+    [[nodiscard]] auto dequeue() noexcept -> gol::task;
+
 public:
+    static constexpr std::size_t s_not_a_worker = static_cast<std::size_t>(-1);
+
     threadpool(threadpool const&) = delete;
     threadpool(threadpool&&) = delete;
     ~threadpool() noexcept;
 
     explicit threadpool(std::size_t num_threads = std::thread::hardware_concurrency());
+    // `pin_threads` pins worker i to CPU i, wrapping around when there are more workers than CPUs
+    threadpool(std::size_t num_threads, bool pin_threads);
 
     auto operator=(threadpool const&) -> threadpool& = delete;
     auto operator=(threadpool &&) -> threadpool& = delete;
@@ -39,25 +69,148 @@ public:
     {
         using T = std::invoke_result_t<F, Args...>;
 
-        auto task =
-            std::make_shared<std::packaged_task<T()>>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        // the shared state is the only allocation, the packaged_task itself fits inside gol::task
+        std::packaged_task<T()> task{ std::bind(std::forward<F>(f), std::forward<Args>(args)...) };
 
-        std::future<T> result = task->get_future();
-        {
-            std::unique_lock<std::mutex> lock{ m_mutex };
+        std::future<T> result = task.get_future();
+        this->enqueue(std::move(task));
 
-            if(m_stop) {
-                throw std::runtime_error{ "Attempted to push to a terminated thread pool!" };
-            }
+        return result;
+    }
+
+    // fire and forget, doesn't allocate unless the captures are bigger than gol::task's inline storage. Use a
+    // task_group to wait for a bunch of them.
+    template<typename F>
+    auto post(F&& f) -> void
+    {
+        this->enqueue(gol::task{ std::forward<F>(f) });
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    // index of the calling thread in the pool it belongs to, s_not_a_worker outside of pools
+    [[nodiscard]] static auto current_worker() noexcept -> std::size_t;
+
+    // Calls fn(chunk_begin, chunk_end) over [begin, end) on the workers and returns once all chunks are done.
+    // Mustn't be called from one of this pool's own tasks, the chunks might never get a worker.
+    template<typename F>
+    auto parallel_for(std::size_t begin,
+                      std::size_t end,
+                      std::size_t grain,
+                      F&& fn,
+                      schedule s = schedule::dynamic_chunks) -> void;
+};
+
+// Runs tasks on a thread pool and waits for all of them at once, without a future per task
+class task_group
+{
+private:
+    threadpool& m_pool;
+    std::size_t m_pending = 0;
+    std::exception_ptr m_error;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+    auto finish(std::exception_ptr error) noexcept -> void;
+
+public:
+    task_group(task_group const&) = delete;
+    task_group(task_group&&) = delete;
+    // waits for whatever is still running, their exceptions are lost
+    ~task_group() noexcept;
+
+    explicit task_group(threadpool& pool) noexcept;
 
-            m_tasks.emplace([task] { (*task)(); });
+    auto operator=(task_group const&) -> task_group& = delete;
+    auto operator=(task_group&&) -> task_group& = delete;
+
+    template<typename F>
+    auto run(F&& f) -> void
+    {
+        {
+            std::lock_guard<std::mutex> const lock{ m_mutex };
+            ++m_pending;
         }
 
-        m_cv.notify_one();
-        return result;
+        try {
+            m_pool.enqueue([this, task = std::forward<F>(f)]() mutable {
+                try {
+                    task();
+                }
+                catch(...) {
+                    this->finish(std::current_exception());
+                    return;
+                }
+                this->finish(nullptr);
+            });
+        }
+        catch(...) {
+            this->finish(nullptr);
+            throw;
+        }
     }
+
+    // rethrows the first exception any of the tasks threw
+    auto wait() -> void;
 };
 
+template<typename F>
+auto threadpool::parallel_for(std::size_t const begin,
+                              std::size_t const end,
+                              std::size_t grain,
+                              F&& fn,
+                              schedule const s) -> void
+{
+    if(begin >= end) {
+        return;
+    }
+
+    grain = std::max<std::size_t>(grain, 1);
+
+    std::size_t const count = end - begin;
+    std::size_t const num_workers = std::max<std::size_t>(m_workers.size(), 1);
+
+    if(s == schedule::static_chunks) {
+        std::size_t const chunk = std::max(grain, (count + num_workers - 1) / num_workers);
+        std::size_t const num_chunks = (count + chunk - 1) / chunk;
+        std::unique_ptr<std::atomic<bool>[]> claimed{ new std::atomic<bool>[num_chunks]() };
+        // after everything its tasks use, so it's gone first even if run() throws
+        task_group group{ *this };
+
+        for(std::size_t i = 0; i < num_chunks; ++i) {
+            group.run([&fn, &claimed, begin, end, chunk, num_chunks] {
+                auto c = current_worker();
+
+                // someone else's chunk if this worker already did its own
+                if(c >= num_chunks || claimed[c].exchange(true)) {
+                    for(c = 0; c < num_chunks && claimed[c].exchange(true); ++c) {
+                    }
+                }
+
+                auto const chunk_begin = begin + c * chunk;
+                fn(chunk_begin, std::min(chunk_begin + chunk, end));
+            });
+        }
+
+        group.wait();
+        return;
+    }
+
+    std::atomic<std::size_t> next{ begin };
+    std::size_t const num_tasks = std::min(num_workers, (count + grain - 1) / grain);
+    task_group group{ *this };
+
+    for(std::size_t i = 0; i < num_tasks; ++i) {
+        group.run([&fn, &next, end, grain] {
+            for(auto b = next.fetch_add(grain); b < end; b = next.fetch_add(grain)) {
+                fn(b, std::min(b + grain, end));
+            }
+        });
+    }
+
+    group.wait();
+}
+
 } // namespace gol
 
 #endif // !GOL_THREAD_THREADPOOL_HPP
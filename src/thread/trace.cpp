@@ -0,0 +1,148 @@
+#include "trace.hpp"
+
+namespace gol {
+
+tracer::~tracer() noexcept
+{
+    this->stop();
+}
+
+auto tracer::get() noexcept -> tracer&
+{
+    static tracer inst;
+    return inst;
+}
+
+auto tracer::local_buffer() -> buffer&
+{
+    thread_local buffer* local = nullptr;
+
+    if(local == nullptr) {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_buffers.push_back(std::make_unique<buffer>());
+        local = m_buffers.back().get();
+    }
+
+    return *local;
+}
+
+auto tracer::start(std::string const& path) -> bool
+{
+    if(m_flusher.joinable()) {
+        return false;
+    }
+
+    m_file.open(path, std::ios::out | std::ios::trunc);
+
+    if(!m_file.is_open()) {
+        return false;
+    }
+
+    m_file << "{\"traceEvents\":[\n";
+    m_origin = clock::now();
+    m_stop = false;
+    m_first_event = true;
+    m_enabled.store(true, std::memory_order_release);
+
+    m_flusher = std::thread{ [this] {
+        std::unique_lock<std::mutex> lock{ m_mutex };
+
+        while(!m_stop) {
+            m_cv.wait_for(lock, s_flush_interval, [this] { return m_stop; });
+
+            lock.unlock();
+            this->flush();
+            lock.lock();
+        }
+    } };
+
+    return true;
+}
+
+auto tracer::stop() -> void
+{
+    if(!m_flusher.joinable()) {
+        return;
+    }
+
+    m_enabled.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_flusher.join();
+
+    // whatever got recorded while the flusher was shutting down
+    this->flush();
+
+    m_file << "\n],\"otherData\":{\"dropped_spans\":" << m_dropped.load() << "}}\n";
+    m_file.close();
+}
+
+auto tracer::flush() -> void
+{
+    std::vector<buffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        for(auto const& buf : m_buffers) {
+            buffers.push_back(buf.get());
+        }
+    }
+
+    for(std::size_t tid = 0; tid < buffers.size(); ++tid) {
+        auto* buf = buffers[tid];
+        span s;
+
+        while(buf->try_pop(s)) {
+            using us = std::chrono::duration<double, std::micro>;
+
+            if(!m_first_event) {
+                m_file << ",\n";
+            }
+            m_first_event = false;
+
+            m_file << R"({"name":")" << s.name << R"(","ph":"X","pid":0,"tid":)" << tid
+                   << R"(,"ts":)" << us{ s.begin - m_origin }.count() << R"(,"dur":)" << us{ s.end - s.begin }.count()
+                   << '}';
+        }
+    }
+
+    m_file.flush();
+}
+
+auto tracer::enabled() const noexcept -> bool
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+auto tracer::record(char const* name, clock::time_point const begin, clock::time_point const end) noexcept -> void
+{
+    if(!this->enabled()) {
+        return;
+    }
+
+    if(!this->local_buffer().try_push({ name, begin, end })) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+trace_span::trace_span(char const* name) noexcept
+    : m_name{ name }
+{
+    if(tracer::get().enabled()) {
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+trace_span::~trace_span() noexcept
+{
+    // tracing wasn't running when the span started
+    if(m_start == std::chrono::steady_clock::time_point{}) {
+        return;
+    }
+
+    tracer::get().record(m_name, m_start, std::chrono::steady_clock::now());
+}
+
+} // namespace gol
@@ -0,0 +1,94 @@
+#ifndef GOL_THREAD_TRACE_HPP
+#define GOL_THREAD_TRACE_HPP
+#pragma once
+
+#include "ring_buffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gol {
+
+// Writes spans in the chrome trace event format (chrome://tracing, ui.perfetto.dev)
+class tracer
+{
+private:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t s_buffer_size = 4096;
+    static constexpr auto s_flush_interval = std::chrono::milliseconds{ 20 };
+
+    struct span
+    {
+        char const* name = nullptr;
+        clock::time_point begin{};
+        clock::time_point end{};
+    };
+
+    // one per thread, only ever pushed to by its thread and popped by the flusher
+    using buffer = gol::ring_buffer<span, s_buffer_size>;
+
+    std::atomic<bool> m_enabled{ false };
+    std::atomic<std::size_t> m_dropped{ 0 };
+    // only guards registering new per-thread buffers and the flusher's sleep, recording never takes it
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<std::unique_ptr<buffer>> m_buffers;
+    std::thread m_flusher;
+    std::ofstream m_file;
+    clock::time_point m_origin{};
+    bool m_stop = false;
+    bool m_first_event = true;
+
+    tracer() = default;
+
+    [[nodiscard]] auto local_buffer() -> buffer&;
+    auto flush() -> void;
+
+public:
+    tracer(tracer const&) = delete;
+    tracer(tracer&&) noexcept = delete;
+    ~tracer() noexcept;
+
+    auto operator=(tracer const&) -> tracer& = delete;
+    auto operator=(tracer&&) noexcept -> tracer& = delete;
+
+    [[nodiscard]] static auto get() noexcept -> tracer&;
+
+    auto start(std::string const& path) -> bool;
+    auto stop() -> void;
+
+    [[nodiscard]] auto enabled() const noexcept -> bool;
+    auto record(char const* name, clock::time_point begin, clock::time_point end) noexcept -> void;
+};
+
+class trace_span
+{
+private:
+    char const* m_name = nullptr;
+    std::chrono::steady_clock::time_point m_start{};
+
+public:
+    trace_span() = delete;
+    trace_span(trace_span const&) = delete;
+    trace_span(trace_span&&) noexcept = delete;
+    ~trace_span() noexcept;
+
+    // `name` must outlive the trace, in practice a string literal
+    explicit trace_span(char const* name) noexcept;
+
+    auto operator=(trace_span const&) -> trace_span& = delete;
+    auto operator=(trace_span&&) noexcept -> trace_span& = delete;
+};
+
+} // namespace gol
+
+#endif // !GOL_THREAD_TRACE_HPP
@@ -0,0 +1,95 @@
+#ifndef GOL_THREAD_TRIPLE_BUFFER_HPP
+#define GOL_THREAD_TRIPLE_BUFFER_HPP
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace gol {
+
+// One writer fills back() and publishes it, one reader picks up the newest published buffer into front(). Neither
+// ever waits for the other, the reader just skips whatever was published while it wasn't looking.
+template<typename T>
+class triple_buffer
+{
+private:
+    static constexpr std::size_t s_cache_line = 64;
+    static constexpr unsigned s_index_mask = 3U;
+    // set while the middle buffer holds something the reader hasn't picked up
+    static constexpr unsigned s_fresh = 4U;
+
+    std::array<T, 3> m_buffers;
+    alignas(s_cache_line) std::atomic<unsigned> m_middle{ 1 };
+    alignas(s_cache_line) unsigned m_back = 0;
+    alignas(s_cache_line) unsigned m_front = 2;
+
+public:
+    triple_buffer() = default;
+    triple_buffer(triple_buffer const&) = delete;
+    triple_buffer(triple_buffer&&) noexcept = delete;
+    ~triple_buffer() noexcept = default;
+
+    explicit triple_buffer(T const& initial)
+        : m_buffers{ initial, initial, initial }
+    {
+    }
+
+    auto operator=(triple_buffer const&) -> triple_buffer& = delete;
+    auto operator=(triple_buffer&&) noexcept -> triple_buffer& = delete;
+
+    // neither side may be using the buffer
+    auto reset(T const& value) -> void
+    {
+        m_buffers.fill(value);
+        m_back = 0;
+        m_middle.store(1, std::memory_order_relaxed);
+        m_front = 2;
+    }
+
+    // like reset() with a fresh make() in every buffer, for values that are expensive to copy
+    template<typename Factory>
+    auto generate(Factory make) -> void
+    {
+        for(auto& buffer : m_buffers) {
+            buffer = make();
+        }
+
+        m_back = 0;
+        m_middle.store(1, std::memory_order_relaxed);
+        m_front = 2;
+    }
+
+    // writer only, what's in it is whatever was published two or more times ago
+    [[nodiscard]] auto back() noexcept -> T&
+    {
+        return m_buffers[m_back];
+    }
+
+    // writer only, back() is a different buffer afterwards
+    auto publish() noexcept -> void
+    {
+        m_back = m_middle.exchange(m_back | s_fresh, std::memory_order_acq_rel) & s_index_mask;
+    }
+
+    // reader only
+    [[nodiscard]] auto front() noexcept -> T&
+    {
+        return m_buffers[m_front];
+    }
+
+    // reader only, true if front() now holds something newer
+    auto update() noexcept -> bool
+    {
+        if((m_middle.load(std::memory_order_relaxed) & s_fresh) == 0) {
+            return false;
+        }
+
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & s_index_mask;
+        return true;
+    }
+};
+
+} // namespace gol
+
+#endif // !GOL_THREAD_TRIPLE_BUFFER_HPP
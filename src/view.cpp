@@ -7,8 +7,12 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <stdexcept>
 #include <string>
 
 // Thanks window.h (again)
@@ -163,101 +167,49 @@ auto camera::translation() const noexcept -> glm::vec3 const&
     return m_translation;
 }
 
-span::span(vertex& v) noexcept
-    : m_ptr{ &v }
-{
-}
-
-auto span::operator[](std::size_t const index) noexcept -> vertex&
-{
-    ASSERT(index < m_len);
-    return m_ptr[index]; // NOLINT
-}
-
-auto span::operator[](std::size_t const index) const noexcept -> vertex const&
-{
-    ASSERT(index < m_len);
-    return m_ptr[index]; // NOLINT
-}
-
-auto span::operator[](int const index) noexcept -> vertex&
-{
-    return this->operator[](static_cast<std::size_t>(index));
-}
-
-auto span::operator[](int const index) const noexcept -> vertex const&
-{
-    return this->operator[](static_cast<std::size_t>(index));
-}
-
-auto span::ptr() noexcept -> vertex*
-{
-    return m_ptr;
-}
-
 view::view(int const w, int const h, color const& a, color const& d)
-    : m_cell_color{ a }
+    : m_initial_alive_cells{ w, h }
+    , m_edits{ w, h }
+    , m_cell_color{ a }
     , m_dead_cell_color{ d }
     , m_width{ w }
     , m_height{ h }
+    , m_pending{ w, h }
+    , m_pyramid{ w, h }
+    , m_level_textures(static_cast<std::size_t>(m_pyramid.levels() + 1), 0)
+    , m_level_staging(static_cast<std::size_t>(density_pyramid::s_tile_size) * density_pyramid::s_tile_size)
 {
     ASSERT(w > 0);
     ASSERT(h > 0);
 
-    constexpr int vertices_per_cell = s_vertices_per_cell;
-    constexpr int indices_per_cell = 6;
+    int max_texture_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
 
-    m_cells.resize(static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * vertices_per_cell);
-    m_indices.reserve(m_cells.size() * indices_per_cell);
+    if(w > max_texture_size || h > max_texture_size) {
+        auto const limit = std::to_string(max_texture_size);
+        throw std::length_error{ "A " + std::to_string(w) + 'x' + std::to_string(h) +
+                                 " board doesn't fit in a texture, the limit is " + limit + 'x' + limit };
+    }
 
     float const total_width = s_cell_dim * static_cast<float>(w);
     float const total_height = s_cell_dim * static_cast<float>(h);
-    float const start_x = -total_width / 2.0F;
-    float const start_y = total_height / 2.0F;
-    float fy = start_y;
-
-    std::size_t index = 0;
-    unsigned int vertex_index = 0;
-
-    for(int y = 0; y < h; ++y) {
-        float fx = start_x;
-        for(int x = 0; x < w; ++x) {
-            constexpr float offset = s_cell_offset;
-            auto cell = span{ m_cells[index] };
-
-            // top left
-            cell[0].x = fx + offset;
-            cell[0].y = fy + offset;
-            // top right
-            cell[1].x = fx + s_cell_dim - offset;
-            cell[1].y = fy + offset;
-            // bottom right
-            cell[2].x = fx + s_cell_dim - offset;
-            cell[2].y = fy + s_cell_dim - offset;
-            // bottom left
-            cell[3].x = fx + offset;
-            cell[3].y = fy + s_cell_dim - offset;
-
-            index += vertices_per_cell;
-            fx += s_cell_dim;
-
-            for(int i = 0; i < s_vertices_per_cell; ++i) {
-                cell[i].r = m_dead_cell_color.r;
-                cell[i].g = m_dead_cell_color.g;
-                cell[i].b = m_dead_cell_color.b;
-            }
-
-            m_indices.push_back(vertex_index);
-            m_indices.push_back(vertex_index + 3);
-            m_indices.push_back(vertex_index + 2);
-            m_indices.push_back(vertex_index + 2);
-            m_indices.push_back(vertex_index);
-            m_indices.push_back(vertex_index + 1);
-            vertex_index += vertices_per_cell;
-        }
-
-        fy -= s_cell_dim;
-    }
+    float const left = -total_width / 2.0F;
+    float const right = total_width / 2.0F;
+    // row 0 starts one cell above the center line, screen_to_grid() relies on it
+    float const top = total_height / 2.0F + s_cell_dim;
+    float const bottom = top - total_height;
+    auto const fw = static_cast<float>(w);
+    auto const fh = static_cast<float>(h);
+
+    // far enough to zoom out until the whole board is a few pixels wide
+    constexpr float far_per_extent = 4.0F;
+    m_far = std::max(s_default_far, far_per_extent * std::max(total_width, total_height));
+
+    // drawn as a triangle strip
+    std::array<vertex, 4> const quad = { vertex{ left, top, 0.0F, 0.0F },
+                                         vertex{ left, bottom, 0.0F, fh },
+                                         vertex{ right, top, fw, 0.0F },
+                                         vertex{ right, bottom, fw, fh } };
 
     program_description desc;
 
@@ -265,67 +217,117 @@ view::view(int const w, int const h, color const& a, color const& d)
     #version 330 core
 
     layout(location = 0) in vec2 pos;
-    layout(location = 1) in vec3 color;
+    layout(location = 1) in vec2 cell;
 
     uniform mat4 projection;
     uniform mat4 view;
 
-    out vec4 f_color;
+    out vec2 f_cell;
 
     void main() {
         gl_Position = projection * view * vec4(pos, 0.0, 1.0);
-        f_color = vec4(color, 1.0);
+        f_cell = cell;
     }
     )";
 
     desc.fragment_shader_source = R"(
     #version 330 core
 
-    in vec4 f_color;
+    in vec2 f_cell;
     out vec4 frag_color;
 
+    uniform usampler2D cells;
+    // 0 draws `cells`, k > 0 draws `density` where a texel covers 2^k x 2^k cells
+    uniform int level;
+    uniform sampler2D density;
+    uniform vec3 alive_color;
+    uniform vec3 dead_color;
+    // width of the gap on each side of a cell, as a fraction of the cell
+    uniform float gap;
+
     void main() {
-        frag_color = f_color;
+        if(level > 0) {
+            ivec2 texel = min(ivec2(f_cell) >> level, textureSize(density, 0) - 1);
+            frag_color = vec4(mix(dead_color, alive_color, texelFetch(density, texel, 0).r), 1.0);
+            return;
+        }
+
+        vec2 inside = fract(f_cell);
+
+        if(any(lessThan(inside, vec2(gap))) || any(greaterThan(inside, vec2(1.0 - gap)))) {
+            discard;
+        }
+
+        uint state = texelFetch(cells, ivec2(f_cell), 0).r;
+        frag_color = vec4(state != 0u ? alive_color : dead_color, 1.0);
     }
     )";
 
     m_program = create_program(desc);
 
+    this->update_projection();
+    m_inverse_view = glm::inverse(m_camera.view());
+
     glUseProgram(m_program);
-    set_mat4(m_program, "projection", glm::perspective(m_fov, m_aspect_ratio, m_near, m_far));
     set_mat4(m_program, "view", m_camera.view());
+    glUniform1i(glGetUniformLocation(m_program, "cells"), 0);
+    glUniform1i(glGetUniformLocation(m_program, "density"), 1);
+    glUniform1i(glGetUniformLocation(m_program, "level"), 0);
+    glUniform1f(glGetUniformLocation(m_program, "gap"), s_cell_offset / s_cell_dim);
     glUseProgram(0);
 
+    this->upload_colors();
+
     glGenVertexArrays(1, &m_vao);
     glBindVertexArray(m_vao);
 
     glGenBuffers(1, &m_vbo);
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(
-        GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_cells.size() * sizeof(vertex)), m_cells.data(), GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad.data(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vertex), nullptr);
     glEnableVertexAttribArray(0);
 
     glVertexAttribPointer(
-        1, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), reinterpret_cast<void*>(offsetof(vertex, r))); // NOLINT
+        1, 2, GL_FLOAT, GL_FALSE, sizeof(vertex), reinterpret_cast<void*>(offsetof(vertex, u))); // NOLINT
     glEnableVertexAttribArray(1);
 
-    glGenBuffers(1, &m_ibo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>(m_indices.size() * sizeof(unsigned int)),
-                 m_indices.data(),
-                 GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, w, h, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // rows are tightly packed bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // the texture starts out undefined, the GPU clears it without anything crossing the bus
+    unsigned int framebuffer = 0;
+    std::array<unsigned int, 4> const dead = { board::s_dead, 0, 0, 0 };
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
+    glClearBufferuiv(GL_COLOR, 0, dead.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+
+    m_pbo_size = std::max(s_upload_budget, static_cast<std::size_t>(w));
+    glGenBuffers(1, &m_pbo);
 }
 
 view::~view() noexcept
 {
-    glDeleteBuffers(1, &m_ibo);
+    glDeleteBuffers(1, &m_pbo);
+    glDeleteTextures(static_cast<int>(m_level_textures.size()), m_level_textures.data());
+    glDeleteTextures(1, &m_texture);
     glDeleteBuffers(1, &m_vbo);
     glDeleteVertexArrays(1, &m_vao);
     glDeleteProgram(m_program);
@@ -333,75 +335,270 @@ view::~view() noexcept
     glClearColor(0.0F, 0.0F, 0.0F, 1.0F);
 }
 
-auto view::cell_at(coord const pos) noexcept -> span
+auto view::upload_colors() noexcept -> void
+{
+    glUseProgram(m_program);
+    glUniform3f(glGetUniformLocation(m_program, "alive_color"), m_cell_color.r, m_cell_color.g, m_cell_color.b);
+    glUniform3f(
+        glGetUniformLocation(m_program, "dead_color"), m_dead_cell_color.r, m_dead_cell_color.g, m_dead_cell_color.b);
+    glUseProgram(0);
+    m_dirty = true;
+}
+
+auto view::update_projection() noexcept -> void
+{
+    m_projection = glm::perspective(m_fov, m_aspect_ratio, m_near, m_far);
+    m_inverse_projection = glm::inverse(m_projection);
+    m_dirty = true;
+
+    glUseProgram(m_program);
+    set_mat4(m_program, "projection", m_projection);
+    glUseProgram(0);
+}
+
+auto view::commit_edits() noexcept -> void
+{
+    if(m_edits.empty()) {
+        return;
+    }
+
+    m_pending.merge(m_edits);
+    m_pyramid.apply(m_edits, m_initial_alive_cells);
+    m_edits.clear();
+}
+
+auto view::set_alive(coord const pos) noexcept -> void
 {
     ASSERT(pos.x < m_width);
     ASSERT(pos.y < m_height);
 
-    return span{ m_cells[static_cast<std::size_t>(pos.y) * static_cast<std::size_t>(m_width) * s_vertices_per_cell +
-                         static_cast<std::size_t>(pos.x) * s_vertices_per_cell] };
+    this->fill(pos, pos, true);
 }
 
-auto view::set_alive_impl(coord const pos) noexcept -> void
+auto view::set_dead(coord const pos) noexcept -> void
 {
     ASSERT(pos.x < m_width);
     ASSERT(pos.y < m_height);
 
-    auto cell = this->cell_at(pos);
-
-    for(int i = 0; i < s_vertices_per_cell; ++i) {
-        cell[i].r = m_cell_color.r;
-        cell[i].g = m_cell_color.g;
-        cell[i].b = m_cell_color.b;
-    }
+    this->fill(pos, pos, false);
+}
 
-    auto const offset =
-        static_cast<unsigned long>(pos.y * m_width * s_vertices_per_cell + pos.x * s_vertices_per_cell) *
-        sizeof(vertex);
+auto view::toggle_at(gol::coord const& pos) noexcept -> void
+{
+    this->fill(pos, pos, !m_initial_alive_cells.test(pos.x, pos.y));
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), sizeof(vertex) * s_vertices_per_cell, cell.ptr());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+auto view::fill(coord const from, coord const to, bool const alive) noexcept -> void
+{
+    m_initial_alive_cells.fill(std::min(from.x, to.x),
+                               std::min(from.y, to.y),
+                               std::max(from.x, to.x) + 1,
+                               std::max(from.y, to.y) + 1,
+                               alive,
+                               m_edits);
+    this->commit_edits();
 }
 
-auto view::set_dead_impl(coord const pos) noexcept -> void
+auto view::randomize(coord const from, coord const to, double const density, std::mt19937_64& rng) -> void
 {
-    ASSERT(pos.x < m_width);
-    ASSERT(pos.y < m_height);
+    m_initial_alive_cells.randomize(std::min(from.x, to.x),
+                                    std::min(from.y, to.y),
+                                    std::max(from.x, to.x) + 1,
+                                    std::max(from.y, to.y) + 1,
+                                    density,
+                                    rng,
+                                    m_edits);
+    this->commit_edits();
+}
 
-    auto cell = this->cell_at(pos);
+auto view::paste(bit_grid const& pattern, coord const at) noexcept -> void
+{
+    m_initial_alive_cells.paste(pattern, at.x, at.y, m_edits);
+    this->commit_edits();
+}
 
-    for(int i = 0; i < s_vertices_per_cell; ++i) {
-        cell[i].r = m_dead_cell_color.r;
-        cell[i].g = m_dead_cell_color.g;
-        cell[i].b = m_dead_cell_color.b;
-    }
+auto view::apply(change_set const& changes, board const& grid) noexcept -> void
+{
+    ASSERT(changes.width() == m_width);
+    ASSERT(changes.height() == m_height);
 
-    auto const offset =
-        static_cast<unsigned long>(pos.y * m_width * s_vertices_per_cell + pos.x * s_vertices_per_cell) *
-        sizeof(vertex);
+    // flips of a cell that changed twice before reaching the texture cancel out, which is what we want
+    m_pending.merge(changes);
+    m_pyramid.apply(changes, grid);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), sizeof(vertex) * s_vertices_per_cell, cell.ptr());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+auto view::upload_pending() const noexcept -> bool
+{
+    return m_level == 0 && !m_pending.empty();
 }
 
-auto view::set_alive(coord const pos) noexcept -> void
+auto view::upload(board const& grid) noexcept -> std::size_t
 {
-    ASSERT(pos.x < m_width);
-    ASSERT(pos.y < m_height);
+    ASSERT(grid.width() == m_width);
+    ASSERT(grid.height() == m_height);
 
-    m_initial_alive_cells.insert(pos);
-    this->set_alive_impl(pos);
+    return this->upload_rows([&grid](int const y, int const x0, int const x1, unsigned char* out) {
+        std::copy(grid.row(y) + x0, grid.row(y) + x1, out); // NOLINT
+    });
 }
 
-auto view::set_dead(coord const pos) noexcept -> void
+template<typename CopyRow>
+auto view::upload_rows(CopyRow&& copy_row) noexcept -> std::size_t
 {
-    ASSERT(pos.x < m_width);
-    ASSERT(pos.y < m_height);
+    // the cells wait in m_pending until they are drawn again
+    if(m_level != 0) {
+        return 0;
+    }
+
+    m_dirty_rows.clear();
+    m_pending.for_each_dirty_row([this](int const y) { m_dirty_rows.push_back(y); });
+
+    std::rotate(m_dirty_rows.begin(),
+                std::lower_bound(m_dirty_rows.begin(), m_dirty_rows.end(), m_upload_cursor),
+                m_dirty_rows.end());
+
+    m_upload_rects.clear();
+
+    std::size_t total = 0;
+    upload_rect rect{};
+    // cells of `rect` that actually changed
+    std::size_t changed = 0;
+
+    auto const area = [](upload_rect const& r) noexcept -> std::size_t {
+        return static_cast<std::size_t>(r.w) * static_cast<std::size_t>(r.h);
+    };
+
+    auto const emit = [this, &total, &rect, &changed, &area] {
+        if(rect.h == 0) {
+            return;
+        }
+
+        rect.offset = total;
+        total += area(rect);
+        m_upload_rects.push_back(rect);
+        rect = upload_rect{};
+        changed = 0;
+    };
+
+    for(int const y : m_dirty_rows) {
+        auto const [begin, end] = m_pending.row_bounds(y);
+
+        if(begin == end) {
+            m_pending.clear_row(y);
+            continue;
+        }
+
+        auto const span = static_cast<std::size_t>(end - begin);
+        bool extended = false;
+
+        if(rect.h != 0 && y == rect.y + rect.h) {
+            upload_rect const grown = { std::min(rect.x, begin),
+                                        rect.y,
+                                        std::max(rect.x + rect.w, end) - std::min(rect.x, begin),
+                                        rect.h + 1,
+                                        0 };
+
+            if(area(grown) <= 2 * (changed + span) + s_coalesce_slack) {
+                if(total + area(grown) > s_upload_budget) {
+                    break;
+                }
+
+                rect = grown;
+                changed += span;
+                extended = true;
+            }
+        }
+
+        if(!extended) {
+            auto const queued = total + area(rect);
+
+            // always send something, even if a single row is over the budget
+            if(queued != 0 && queued + span > s_upload_budget) {
+                break;
+            }
+
+            emit();
+            rect = { begin, y, end - begin, 1, 0 };
+            changed = span;
+        }
+
+        m_upload_cursor = y + 1;
+    }
+
+    emit();
+
+    if(m_upload_rects.empty()) {
+        return 0;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+    // orphaning hands us fresh storage instead of waiting for the GPU to finish reading the last upload
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(m_pbo_size), nullptr, GL_STREAM_DRAW);
+
+    auto* staging = static_cast<unsigned char*>(glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(total), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+    if(staging != nullptr) {
+        for(auto const& r : m_upload_rects) {
+            auto* out = staging + r.offset; // NOLINT
+
+            for(int y = r.y; y < r.y + r.h; ++y) {
+                copy_row(y, r.x, r.x + r.w, out);
+                out += r.w; // NOLINT
+            }
+        }
+
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        for(auto const& r : m_upload_rects) {
+            glTexSubImage2D(GL_TEXTURE_2D,
+                            0,
+                            r.x,
+                            r.y,
+                            r.w,
+                            r.h,
+                            GL_RED_INTEGER,
+                            GL_UNSIGNED_BYTE,
+                            reinterpret_cast<void const*>(r.offset)); // NOLINT
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    else {
+        WARN("Could not map the staging buffer, uploading a row at a time");
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        std::vector<unsigned char> row;
+
+        for(auto const& r : m_upload_rects) {
+            row.resize(static_cast<std::size_t>(r.w));
+
+            for(int y = r.y; y < r.y + r.h; ++y) {
+                copy_row(y, r.x, r.x + r.w, row.data());
+                glTexSubImage2D(GL_TEXTURE_2D, 0, r.x, y, r.w, 1, GL_RED_INTEGER, GL_UNSIGNED_BYTE, row.data());
+            }
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for(auto const& r : m_upload_rects) {
+        for(int y = r.y; y < r.y + r.h; ++y) {
+            m_pending.clear_row(y);
+        }
+    }
 
-    m_initial_alive_cells.erase(pos);
-    this->set_dead_impl(pos);
+    m_dirty = true;
+
+    return total;
+}
+
+auto view::upload_edits() noexcept -> std::size_t
+{
+    return this->upload_rows([this](int const y, int const x0, int const x1, unsigned char* out) {
+        m_initial_alive_cells.expand_row(y, x0, x1, out);
+    });
 }
 
 auto view::set_cell_color(float const r, float const g, float const b) noexcept -> void
@@ -409,6 +606,7 @@ auto view::set_cell_color(float const r, float const g, float const b) noexcept
     m_cell_color.r = r;
     m_cell_color.g = g;
     m_cell_color.b = b;
+    this->upload_colors();
 }
 
 auto view::set_dead_cell_color(float const r, float const g, float const b) noexcept -> void
@@ -416,37 +614,155 @@ auto view::set_dead_cell_color(float const r, float const g, float const b) noex
     m_dead_cell_color.r = r;
     m_dead_cell_color.g = g;
     m_dead_cell_color.b = b;
+    this->upload_colors();
+}
+
+auto view::pick_level() const noexcept -> int
+{
+    float const distance = -m_camera.position().z;
+
+    if(m_viewport_height <= 0 || distance <= 0.0F) {
+        return 0;
+    }
+
+    // [1][1] is 1 / tan(fov / 2)
+    float const visible_height = 2.0F * distance / this->projection_matrix()[1][1];
+    float cells_per_pixel = visible_height / s_cell_dim / static_cast<float>(m_viewport_height);
+    int k = 0;
+
+    while(k < m_pyramid.levels() && cells_per_pixel >= 2.0F) {
+        cells_per_pixel /= 2.0F;
+        ++k;
+    }
+
+    return k;
+}
+
+auto view::refresh_level(int const k) noexcept -> void
+{
+    auto& texture = m_level_textures[static_cast<std::size_t>(k)];
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    if(texture == 0) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexImage2D(GL_TEXTURE_2D,
+                     0,
+                     GL_R8,
+                     m_pyramid.width(k),
+                     m_pyramid.height(k),
+                     0,
+                     GL_RED,
+                     GL_UNSIGNED_BYTE,
+                     nullptr);
+        m_pyramid.mark_dirty(k);
+    }
+
+    // the part of the board plane inside the frustum, the camera looks straight at it
+    auto const& pos = m_camera.position();
+    auto const projection = this->projection_matrix();
+    float const distance = -pos.z;
+    float const half_width = distance / projection[0][0];
+    float const half_height = distance / projection[1][1];
+    float const left = -static_cast<float>(m_width) * s_cell_dim / 2.0F;
+    float const top = static_cast<float>(m_height) * s_cell_dim / 2.0F + s_cell_dim;
+
+    auto const to_texel = [k](float const cells, int const size) noexcept -> int {
+        return std::clamp(static_cast<int>(std::floor(cells)) >> k, 0, size);
+    };
+
+    int const x0 = to_texel((-pos.x - half_width - left) / s_cell_dim, m_pyramid.width(k));
+    int const x1 = to_texel((-pos.x + half_width - left) / s_cell_dim, m_pyramid.width(k) - 1) + 1;
+    int const y0 = to_texel((top - (-pos.y + half_height)) / s_cell_dim, m_pyramid.height(k));
+    int const y1 = to_texel((top - (-pos.y - half_height)) / s_cell_dim, m_pyramid.height(k) - 1) + 1;
+
+    m_pyramid.take_dirty(k, x0, y0, x1, y1, [this, k](int const x, int const y, int const w, int const h) {
+        m_dirty = true;
+
+        // runs of tiles are uploaded a tile at a time so the staging buffer stays small
+        for(int tx = x; tx < x + w; tx += density_pyramid::s_tile_size) {
+            int const tw = std::min(density_pyramid::s_tile_size, x + w - tx);
+            auto* out = m_level_staging.data();
+
+            for(int ty = y; ty < y + h; ++ty) {
+                for(int i = 0; i < tw; ++i) {
+                    *out++ = m_pyramid.density(k, tx + i, ty); // NOLINT
+                }
+            }
+
+            glTexSubImage2D(GL_TEXTURE_2D, 0, tx, y, tw, h, GL_RED, GL_UNSIGNED_BYTE, m_level_staging.data());
+        }
+    });
 }
 
-auto view::update() noexcept -> void
+auto view::update() noexcept -> bool
 {
+    int const k = this->pick_level();
+
+    if(k != 0) {
+        glActiveTexture(GL_TEXTURE1);
+        this->refresh_level(k);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    if(k != m_level) {
+        m_level = k;
+        m_dirty = true;
+    }
+
+    if(!m_dirty) {
+        return false;
+    }
+
+    m_dirty = false;
+
     glClear(GL_COLOR_BUFFER_BIT);
 
     glUseProgram(m_program);
+    glUniform1i(glGetUniformLocation(m_program, "level"), k);
     glBindVertexArray(m_vao);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
 
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), GL_UNSIGNED_INT, nullptr);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
     glBindVertexArray(0);
     glUseProgram(0);
+
+    return true;
+}
+
+auto view::invalidate() noexcept -> void
+{
+    m_dirty = true;
 }
 
 auto view::set_aspect_ratio(float const a) noexcept -> void
 {
     m_aspect_ratio = a;
-    glUseProgram(m_program);
-    set_mat4(m_program, "projection", glm::perspective(m_fov, a, m_near, m_far));
-    glUseProgram(0);
+    this->update_projection();
+}
+
+auto view::set_viewport(int const w, int const h) noexcept -> void
+{
+    m_viewport_height = h;
+    this->set_aspect_ratio(static_cast<float>(w) / static_cast<float>(h));
 }
 
 auto view::set_fov(float const fov) noexcept -> void
 {
     m_fov = fov;
-    glUseProgram(m_program);
-    set_mat4(m_program, "projection", glm::perspective(fov, m_aspect_ratio, m_near, m_far));
-    glUseProgram(0);
+    this->update_projection();
 }
 
 auto view::get_fov() const noexcept -> float
@@ -457,7 +773,9 @@ auto view::get_fov() const noexcept -> float
 auto view::translate(glm::vec3 const v) noexcept -> void
 {
     m_camera.translate(v);
+    m_inverse_view = glm::inverse(m_camera.view());
     update_cam(m_program, "view", m_camera);
+    m_dirty = true;
 }
 
 auto view::view_matrix() const noexcept -> glm::mat4
@@ -467,7 +785,7 @@ auto view::view_matrix() const noexcept -> glm::mat4
 
 auto view::projection_matrix() const noexcept -> glm::mat4
 {
-    return glm::perspective(m_fov, m_aspect_ratio, m_near, m_far);
+    return m_projection;
 }
 
 auto view::near() const noexcept -> float
@@ -490,19 +808,93 @@ auto view::height() const noexcept -> int
     return m_height;
 }
 
-auto view::toggle_at(gol::coord const& pos) noexcept -> void
+auto view::level() const noexcept -> int
 {
-    if(m_initial_alive_cells.find(pos) != m_initial_alive_cells.end()) {
-        this->set_dead(pos);
-    }
-    else {
-        this->set_alive(pos);
-    }
+    return m_level;
 }
 
-auto view::get_initial_alive_cells() const noexcept -> std::set<coord> const&
+auto view::population() const noexcept -> std::size_t
+{
+    return m_pyramid.population();
+}
+
+auto view::screen_to_grid(int const x, int const y, int const screen_width, int const screen_height) const noexcept
+    -> coord
+{
+    float const nds_x = (2.0F * static_cast<float>(x)) / static_cast<float>(screen_width) - 1.0F;
+    float const nds_y = -((2.0F * static_cast<float>(y)) / static_cast<float>(screen_height) - 1.0F);
+    glm::vec4 const ray_clip = glm::vec4{ nds_x, nds_y, -1.0F, 1.0F }; // NOLINT
+    glm::vec4 ray_eye = m_inverse_projection * ray_clip;
+    ray_eye = glm::vec4(ray_eye.x, ray_eye.y, -1.0F, 0.0F); // NOLINT
+    glm::vec3 ray_wor = m_inverse_view * ray_eye;
+    TRACE("wx={}, wy={}", ray_wor.x, ray_wor.y); // NOLINT
+
+    float const grid_width = static_cast<float>(m_width) * s_cell_dim;
+    float const grid_height = static_cast<float>(m_height) * s_cell_dim;
+
+    float const absx = ray_wor.x + grid_width / 2.0F;                          // NOLINT
+    float const absy = std::abs(ray_wor.y - grid_height / 2.0F - s_cell_dim); // NOLINT
+
+    auto const grid_x = static_cast<int>(absx / s_cell_dim);
+    auto const grid_y = static_cast<int>(absy / s_cell_dim);
+
+    return { grid_x, grid_y };
+}
+
+auto view::get_initial_alive_cells() const noexcept -> bit_grid const&
 {
     return m_initial_alive_cells;
 }
 
+auto view::estimate_memory(int const w, int const h, memory_report& report) -> void
+{
+    auto const cells = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+    std::size_t level_textures = 0;
+
+    for(int k = 1; k <= density_pyramid::s_max_level; ++k) {
+        auto const scale = std::size_t{ 1 } << static_cast<unsigned>(k);
+        auto const texels = ((static_cast<std::size_t>(w) + scale - 1) / scale) *
+                            ((static_cast<std::size_t>(h) + scale - 1) / scale);
+
+        level_textures += texels;
+
+        if(texels == 1) {
+            break;
+        }
+    }
+
+    report.add("view", "initial cells (bit grid)", bit_grid::memory_usage(w, h));
+    report.add("view", "edit flips (change set)", change_set::memory_usage(w, h));
+    report.add("view", "pending uploads (change set)", change_set::memory_usage(w, h));
+    report.add("view", "density pyramid", density_pyramid::memory_usage(w, h));
+    report.add("view", "upload queue", static_cast<std::size_t>(h) * sizeof(int));
+    report.add("view (GPU)", "cell texture", cells);
+    report.add("view (GPU)", "staging buffer", std::max(s_upload_budget, static_cast<std::size_t>(w)));
+    report.add("view (GPU)", "density textures", level_textures);
+}
+
+auto view::report_memory(memory_report& report) const -> void
+{
+    std::size_t level_textures = 0;
+
+    for(int k = 1; k <= m_pyramid.levels(); ++k) {
+        if(m_level_textures[static_cast<std::size_t>(k)] != 0) {
+            level_textures +=
+                static_cast<std::size_t>(m_pyramid.width(k)) * static_cast<std::size_t>(m_pyramid.height(k));
+        }
+    }
+
+    report.add("view", "initial cells (bit grid)", m_initial_alive_cells.memory_usage());
+    report.add("view", "edit flips (change set)", m_edits.memory_usage());
+    report.add("view", "pending uploads (change set)", m_pending.memory_usage());
+    report.add("view", "density pyramid", m_pyramid.memory_usage());
+    report.add("view",
+               "upload queue",
+               m_dirty_rows.capacity() * sizeof(int) + m_upload_rects.capacity() * sizeof(upload_rect) +
+                   m_level_staging.capacity());
+    report.add("view (GPU)", "cell texture", static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height));
+    report.add("view (GPU)", "staging buffer", m_pbo_size);
+    report.add("view (GPU)", "density textures", level_textures);
+}
+
 } // namespace gol
@@ -4,13 +4,19 @@
 
 #include <array>
 #include <cstddef>
-#include <set>
+#include <random>
 #include <vector>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
 #include "coord.hpp"
+#include "memory.hpp"
+
+#include "engine/bit_grid.hpp"
+#include "engine/board.hpp"
+#include "engine/change_set.hpp"
+#include "engine/density_pyramid.hpp"
 
 // Thanks windows.h
 #undef near
@@ -54,13 +60,13 @@ public:
     [[nodiscard]] auto translation() const noexcept -> glm::vec3 const&;
 };
 
+// corner of the board quad, (u, v) is the same point in cells with (0, 0) at the top left of the board
 struct vertex
 {
     float x = 0.0F;
     float y = 0.0F;
-    float r = 0.0F;
-    float g = 0.0F;
-    float b = 0.0F;
+    float u = 0.0F;
+    float v = 0.0F;
 };
 
 struct color
@@ -70,38 +76,16 @@ struct color
     float b = 0.0F;
 };
 
-class span
-{
-private:
-    vertex* m_ptr = nullptr;
-    static constexpr int m_len = 4;
-
-public:
-    span() noexcept = default;
-    span(span const&) noexcept = default;
-    span(span&&) noexcept = default;
-    ~span() noexcept = default;
-
-    explicit span(vertex& v) noexcept;
-
-    auto operator=(span const&) noexcept -> span& = default;
-    auto operator=(span&&) noexcept -> span& = default;
-
-    [[nodiscard]] auto operator[](std::size_t index) noexcept -> vertex&;
-    [[nodiscard]] auto operator[](std::size_t index) const noexcept -> vertex const&;
-
-    [[nodiscard]] auto operator[](int index) noexcept -> vertex&;
-    [[nodiscard]] auto operator[](int index) const noexcept -> vertex const&;
-
-    [[nodiscard]] auto ptr() noexcept -> vertex*;
-};
-
+// The board is a single channel texture with a byte per cell, drawn as one quad. The fragment shader picks the color
+// of the cell under it and leaves the gap between cells empty. Zoomed out far enough that a pixel covers 2x2 cells or
+// more, the quad samples a level of a density pyramid instead, and only the visible part of that level is kept up to
+// date on the GPU.
 class view
 {
 private:
-    std::vector<vertex> m_cells;
-    std::set<coord> m_initial_alive_cells;
-    std::vector<unsigned int> m_indices;
+    bit_grid m_initial_alive_cells;
+    // flips of the edit in progress
+    change_set m_edits;
 
     static constexpr color s_default_cell_color = { 1.0F, 1.0F, 1.0F };
     static constexpr color s_default_dead_cell_color = { 1.0F, 0.0F, 0.0F };
@@ -124,19 +108,65 @@ private:
     float m_near = s_default_near;
     float m_far = s_default_far;
     camera m_camera{ glm::vec3{ 0.0F, 0.0F, s_default_cam_offset }, glm::vec3{ 0.0F, 0.0F, 0.0F } };
+    // kept up to date by update_projection() and translate() so screen_to_grid() doesn't invert anything
+    glm::mat4 m_projection{ 1.0F };
+    glm::mat4 m_inverse_projection{ 1.0F };
+    glm::mat4 m_inverse_view{ 1.0F };
 
     static constexpr float s_cell_dim = 0.1F;
-    static constexpr int s_vertices_per_cell = 4;
+
+    // a rectangle of the texture and where its cells are in the staging buffer
+    struct upload_rect
+    {
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+        std::size_t offset = 0;
+    };
+
+    // most bytes upload() sends at once
+    static constexpr std::size_t s_upload_budget = std::size_t{ 8 } << 20U;
+    // unchanged cells a rectangle may carry to save a transfer, besides up to as many as it has changed
+    static constexpr std::size_t s_coalesce_slack = 4096;
+
+    // changes that are in the board handed to upload() but not in the texture yet
+    change_set m_pending;
+    // upload() starts from here, so rows further down aren't starved when the budget runs out
+    int m_upload_cursor = 0;
+    std::vector<int> m_dirty_rows;
+    std::vector<upload_rect> m_upload_rects;
+
+    density_pyramid m_pyramid;
+    // drawn by the last update(), 0 is the cell texture
+    int m_level = 0;
+    // one per pyramid level, created the first time it's drawn. Index 0 is unused.
+    std::vector<unsigned int> m_level_textures;
+    std::vector<unsigned char> m_level_staging;
+    int m_viewport_height = 0;
+    // something on screen changed since the last draw
+    bool m_dirty = true;
 
     unsigned int m_vao = 0;
     unsigned int m_vbo = 0;
-    unsigned int m_ibo = 0;
+    unsigned int m_texture = 0;
+    // staging for upload(), orphaned every call
+    unsigned int m_pbo = 0;
+    std::size_t m_pbo_size = 0;
     unsigned int m_program = 0;
 
-    [[nodiscard]] auto cell_at(coord pos) noexcept -> span;
+    auto upload_colors() noexcept -> void;
+    auto update_projection() noexcept -> void;
+    // queues m_edits for upload_edits()
+    auto commit_edits() noexcept -> void;
+    // upload() with copy_row(y, x0, x1, out) writing cells [x0, x1) of row y to `out` a byte each
+    template<typename CopyRow>
+    auto upload_rows(CopyRow&& copy_row) noexcept -> std::size_t;
 
-    auto set_alive_impl(coord pos) noexcept -> void;
-    auto set_dead_impl(coord pos) noexcept -> void;
+    // coarsest level whose texels still cover at least a pixel
+    [[nodiscard]] auto pick_level() const noexcept -> int;
+    // copies the dirty texels of pyramid level k that are on screen to its texture
+    auto refresh_level(int k) noexcept -> void;
 
 public:
     view() = delete;
@@ -144,6 +174,7 @@ public:
     view(view&&) noexcept = default;
     ~view() noexcept;
 
+    // throws std::length_error if a `w` x `h` board doesn't fit in a texture
     view(int w, int h, color const& a = s_default_cell_color, color const& d = s_default_dead_cell_color);
 
     auto operator=(view const&) -> view& = default;
@@ -151,13 +182,36 @@ public:
 
     auto set_alive(coord pos) noexcept -> void;
     auto set_dead(coord pos) noexcept -> void;
+    auto toggle_at(gol::coord const& pos) noexcept -> void;
+    // Edits of the initial cells in the rectangle with corners `from` and `to`, both included, clipped to the board.
+    // Each one is a single write to the cells that queues what changed for one batched upload_edits().
+    auto fill(coord from, coord to, bool alive) noexcept -> void;
+    auto randomize(coord from, coord to, double density, std::mt19937_64& rng) -> void;
+    // `pattern` with its top left corner at `at`, dead cells included
+    auto paste(bit_grid const& pattern, coord at) noexcept -> void;
+    // upload() of the edited cells, expanded from their bits on the way
+    auto upload_edits() noexcept -> std::size_t;
+
+    // queues every cell in `changes` for the next upload(), `grid` is the board with the changes applied
+    auto apply(change_set const& changes, board const& grid) noexcept -> void;
+    // Copies the queued cells from `grid` to the texture as a few rectangles, each covering a run of dirty rows. At
+    // most s_upload_budget bytes are sent, the rest stays queued for the next call. Returns the number of bytes sent.
+    // Nothing is sent while a pyramid level is drawn instead of the cells.
+    auto upload(board const& grid) noexcept -> std::size_t;
+    [[nodiscard]] auto upload_pending() const noexcept -> bool;
 
     auto set_cell_color(float r, float g, float b) noexcept -> void;
     auto set_dead_cell_color(float r, float g, float b) noexcept -> void;
 
-    auto update() noexcept -> void;
+    // Draws the board if the camera, the viewport, the colors or the texture changed since the last draw. Returns
+    // false without touching the framebuffer otherwise, so the caller can skip the swap too.
+    auto update() noexcept -> bool;
+    // the next update() draws even if nothing changed, e.g. after the window was uncovered
+    auto invalidate() noexcept -> void;
 
     auto set_aspect_ratio(float a) noexcept -> void;
+    // size of the window in pixels, also sets the aspect ratio
+    auto set_viewport(int w, int h) noexcept -> void;
     auto set_fov(float fov) noexcept -> void;
 
     [[nodiscard]] auto get_fov() const noexcept -> float;
@@ -172,15 +226,24 @@ public:
 
     [[nodiscard]] auto width() const noexcept -> int;
     [[nodiscard]] auto height() const noexcept -> int;
+    // 0 when cells are drawn, k when a texel covers 2^k x 2^k cells
+    [[nodiscard]] auto level() const noexcept -> int;
+    // alive cells of the whole board being shown, or about to be
+    [[nodiscard]] auto population() const noexcept -> std::size_t;
 
     [[nodiscard]] constexpr static auto cell_dimension() noexcept -> float
     {
         return s_cell_dim;
     }
 
-    auto toggle_at(gol::coord const& pos) noexcept -> void;
+    [[nodiscard]] auto screen_to_grid(int x, int y, int screen_width, int screen_height) const noexcept -> coord;
+
+    [[nodiscard]] auto get_initial_alive_cells() const noexcept -> bit_grid const&;
 
-    [[nodiscard]] auto get_initial_alive_cells() const noexcept -> std::set<coord> const&;
+    // what a w x h view allocates on the CPU and the GPU, every pyramid level included
+    static auto estimate_memory(int w, int h, memory_report& report) -> void;
+    // what this view holds right now
+    auto report_memory(memory_report& report) const -> void;
 };
 
 } // namespace gol
@@ -0,0 +1,476 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "census.hpp"
+
+#include "engine/bit_grid.hpp"
+#include "engine/change_set.hpp"
+#include "engine/density_pyramid.hpp"
+#include "engine/engine.hpp"
+#include "engine/pattern.hpp"
+#include "engine/validate.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// `rows` ('O' alive) with its top left at (x, y) of a row-major grid `width` cells wide
+auto draw(std::vector<unsigned char>& grid,
+          int const width,
+          std::vector<std::string> const& rows,
+          int const x,
+          int const y) -> void
+{
+    for(std::size_t dy = 0; dy < rows.size(); ++dy) {
+        for(std::size_t dx = 0; dx < rows[dy].size(); ++dx) {
+            if(rows[dy][dx] == 'O') {
+                auto const i = (static_cast<std::size_t>(y) + dy) * static_cast<std::size_t>(width) + dx;
+                grid[i + static_cast<std::size_t>(x)] = 1;
+            }
+        }
+    }
+}
+
+[[nodiscard]] auto census_of(std::vector<std::string> const& rows) -> std::map<std::string, int>
+{
+    constexpr int margin = 3;
+    auto const width = static_cast<int>(rows.front().size()) + 2 * margin;
+    auto const height = static_cast<int>(rows.size()) + 2 * margin;
+    std::vector<unsigned char> grid(static_cast<std::size_t>(width) * static_cast<std::size_t>(height), 0);
+
+    draw(grid, width, rows, margin, margin);
+    return gol::census{}.run(grid, width, height);
+}
+
+// gets every cell on the left edge wrong
+class broken_engine : public gol::sliding_engine
+{
+protected:
+    auto step_impl(gol::board const& current, gol::board& next) -> void override
+    {
+        gol::sliding_engine::step_impl(current, next);
+
+        for(int y = 0; y < current.height(); ++y) {
+            if(current.at(0, y) == gol::board::s_alive && current.at(1, y) == gol::board::s_alive) {
+                next.at(0, y) = gol::board::s_alive;
+            }
+        }
+    }
+};
+
+TEST_CASE("Rule parsing")
+{
+    auto const life = gol::parse_rule("B3/S23");
+    REQUIRE(life.has_value());
+    REQUIRE(*life == gol::rule{});
+    REQUIRE(gol::to_string(*life) == "B3/S23");
+
+    auto const highlife = gol::parse_rule("b36/s23");
+    REQUIRE(highlife.has_value());
+    REQUIRE(gol::to_string(*highlife) == "B36/S23");
+
+    REQUIRE(!gol::parse_rule("B9/S23").has_value());
+    REQUIRE(!gol::parse_topology("sphere").has_value());
+}
+
+TEST_CASE("Engines agree with the reference")
+{
+    constexpr int trials = 100;
+    constexpr int generations = 16;
+
+    for(auto const& name : gol::available_engines()) {
+        auto e = gol::make_engine(name, 4);
+        REQUIRE(e != nullptr);
+
+        auto const d = gol::validate_random(*e, 1, trials, generations);
+        INFO(name);
+        REQUIRE(!d.has_value());
+    }
+}
+
+TEST_CASE("Blinker wraps around a torus")
+{
+    gol::board b{ 5, 5 };
+    b.at(4, 1) = gol::board::s_alive;
+    b.at(4, 2) = gol::board::s_alive;
+    b.at(4, 3) = gol::board::s_alive;
+
+    auto const next = gol::reference_step(b, gol::rule{}, gol::topology::torus);
+    REQUIRE(next.population() == 3);
+    REQUIRE(next.at(3, 2) == gol::board::s_alive);
+    REQUIRE(next.at(4, 2) == gol::board::s_alive);
+    REQUIRE(next.at(0, 2) == gol::board::s_alive);
+
+    auto const bounded = gol::reference_step(b, gol::rule{}, gol::topology::bounded);
+    REQUIRE(bounded.population() == 2);
+}
+
+TEST_CASE("Divergences are found and minimized")
+{
+    broken_engine e;
+
+    auto const d = gol::validate_random(e, 1, 100, 16);
+    REQUIRE(d.has_value());
+    REQUIRE(d->engine == "sliding");
+
+    // a wrong cell on the left edge and its neighbors, unless the board wraps
+    if(d->topology == gol::topology::bounded) {
+        REQUIRE(d->input.width() <= 3);
+        REQUIRE(d->input.height() <= 3);
+    }
+}
+
+TEST_CASE("Change sets replay the generations they were recorded from")
+{
+    constexpr int width = 130;
+    constexpr int height = 70;
+
+    gol::board current{ width, height };
+    for(int x = 0; x < width; ++x) {
+        current.at(x, height / 2) = gol::board::s_alive;
+    }
+
+    gol::sliding_engine e;
+    gol::board next{ width, height };
+    gol::board replayed = current;
+    gol::change_set merged{ width, height };
+    gol::board merged_replay = current;
+
+    for(int i = 0; i < 20; ++i) {
+        e.step(current, next);
+
+        gol::change_set changes{ width, height };
+        changes.record(current, next);
+        changes.apply(replayed);
+        merged.merge(changes);
+
+        REQUIRE(replayed == next);
+        std::swap(current, next);
+    }
+
+    merged.apply(merged_replay);
+    REQUIRE(merged_replay == current);
+
+    merged.clear();
+    REQUIRE(merged.empty());
+}
+
+TEST_CASE("Change sets visit flips row by row")
+{
+    gol::change_set changes{ 100, 100 };
+    changes.flip(99, 64);
+    changes.flip(0, 3);
+    changes.flip(64, 3);
+    changes.flip(64, 3);
+
+    std::vector<std::pair<int, int>> flips;
+    changes.for_each_flip([&flips](int const x, int const y) { flips.emplace_back(x, y); });
+
+    REQUIRE(flips == std::vector<std::pair<int, int>>{ { 0, 3 }, { 99, 64 } });
+    REQUIRE(changes.row_dirty(64));
+    REQUIRE(!changes.row_dirty(63));
+}
+
+TEST_CASE("Change sets know the bounds of every row")
+{
+    gol::change_set changes{ 200, 4 };
+    changes.flip(5, 1);
+    changes.flip(130, 1);
+    changes.flip(199, 2);
+    changes.flip(70, 3);
+    changes.flip(70, 3);
+
+    REQUIRE(changes.row_bounds(0) == std::pair<int, int>{ 0, 0 });
+    REQUIRE(changes.row_bounds(1) == std::pair<int, int>{ 5, 131 });
+    REQUIRE(changes.row_bounds(2) == std::pair<int, int>{ 199, 200 });
+    REQUIRE(changes.row_bounds(3) == std::pair<int, int>{ 0, 0 });
+
+    changes.clear_row(1);
+    REQUIRE(!changes.row_dirty(1));
+    REQUIRE(changes.row_bounds(1) == std::pair<int, int>{ 0, 0 });
+    REQUIRE(changes.row_dirty(2));
+}
+
+TEST_CASE("Density pyramids follow the generations")
+{
+    constexpr int w = 150;
+    constexpr int h = 70;
+    gol::sliding_engine e;
+    gol::board current{ w, h };
+    for(int y = 0; y < h; ++y) {
+        for(int x = 0; x < w; ++x) {
+            current.at(x, y) = static_cast<unsigned char>((x * 7 + y * 13) % 5 == 0);
+        }
+    }
+    gol::board next{ w, h };
+    gol::board shown{ w, h };
+    gol::change_set changes{ w, h };
+    gol::density_pyramid pyramid{ w, h };
+
+    REQUIRE(pyramid.levels() == 7);
+    REQUIRE(pyramid.width(1) == 75);
+    REQUIRE(pyramid.height(3) == 9);
+    REQUIRE(pyramid.width(7) == 2);
+
+    for(int generation = 0; generation < 10; ++generation) {
+        changes.record(shown, current);
+        changes.apply(shown);
+        pyramid.apply(changes, shown);
+        changes.clear();
+
+        e.step(current, next);
+        std::swap(current, next);
+    }
+
+    for(int k = 1; k <= pyramid.levels(); ++k) {
+        for(int y = 0; y < pyramid.height(k); ++y) {
+            for(int x = 0; x < pyramid.width(k); ++x) {
+                int expected = 0;
+
+                for(int cy = y << k; cy < std::min((y + 1) << k, h); ++cy) {
+                    for(int cx = x << k; cx < std::min((x + 1) << k, w); ++cx) {
+                        expected += shown.at(cx, cy);
+                    }
+                }
+
+                REQUIRE(pyramid.count(k, x, y) == expected);
+            }
+        }
+    }
+
+    REQUIRE(pyramid.population() == shown.population());
+}
+
+TEST_CASE("Density pyramids hand out dirty tiles once")
+{
+    gol::density_pyramid pyramid{ 1000, 300 };
+    pyramid.add(0, 0, 1);
+    pyramid.add(999, 299, 1);
+    pyramid.add(140, 0, 1);
+
+    // level 1 is 500x150 texels, the flips are in tiles (0, 0), (1, 0) and (7, 2)
+    std::vector<std::vector<int>> rects;
+    auto const collect = [&rects](int x, int y, int w, int h) { rects.push_back({ x, y, w, h }); };
+
+    pyramid.take_dirty(1, 0, 0, 100, 150, collect);
+    REQUIRE(rects == std::vector<std::vector<int>>{ { 0, 0, 128, 64 } });
+
+    rects.clear();
+    pyramid.take_dirty(1, 0, 0, 500, 150, collect);
+    REQUIRE(rects == std::vector<std::vector<int>>{ { 448, 128, 52, 22 } });
+
+    rects.clear();
+    pyramid.take_dirty(1, 0, 0, 500, 150, collect);
+    REQUIRE(rects.empty());
+    REQUIRE(pyramid.density(1, 0, 0) == 64);
+}
+
+TEST_CASE("Bit grids copy their cells onto boards")
+{
+    gol::bit_grid cells{ 130, 3 };
+    REQUIRE(cells.count() == 0);
+
+    cells.set(0, 0);
+    cells.set(63, 1);
+    cells.set(64, 1);
+    cells.set(129, 2);
+    cells.set(129, 2);
+    cells.reset(0, 0);
+    REQUIRE(cells.count() == 3);
+    REQUIRE(cells.test(64, 1));
+    REQUIRE_FALSE(cells.test(0, 0));
+
+    std::vector<std::pair<int, int>> visited;
+    cells.for_each_set([&visited](int const x, int const y) { visited.emplace_back(x, y); });
+    REQUIRE(visited == std::vector<std::pair<int, int>>{ { 63, 1 }, { 64, 1 }, { 129, 2 } });
+
+    gol::board b{ 130, 3 };
+    cells.copy_to(b);
+    REQUIRE(b.population() == 3);
+    REQUIRE(b.at(129, 2) == gol::board::s_alive);
+
+    // a byte per cell across a word boundary
+    std::vector<unsigned char> row(70, 0xFF);
+    cells.expand_row(1, 60, 130, row.data());
+    REQUIRE(std::count(row.begin(), row.end(), gol::board::s_alive) == 2);
+    REQUIRE(row[3] == gol::board::s_alive);
+    REQUIRE(row[4] == gol::board::s_alive);
+    REQUIRE(row[5] == gol::board::s_dead);
+}
+
+TEST_CASE("Bit grid edits flip what they change")
+{
+    gol::bit_grid cells{ 200, 10 };
+    gol::change_set changes{ 200, 10 };
+
+    cells.fill(60, 2, 140, 4, true, changes);
+    REQUIRE(cells.count() == 160);
+    REQUIRE(changes.row_bounds(2) == std::pair<int, int>{ 60, 140 });
+    REQUIRE_FALSE(changes.row_dirty(4));
+
+    // only the cells that were alive flip back
+    changes.clear();
+    cells.fill(-5, 3, 100, 20, false, changes);
+    REQUIRE(cells.count() == 80 + 40);
+    REQUIRE(changes.row_bounds(3) == std::pair<int, int>{ 60, 100 });
+
+    std::istringstream glider{ "#C a glider\nx = 3, y = 3, rule = B3/S23\nbob$2bo$3o!\n" };
+    auto const pattern = gol::read_pattern(glider);
+    REQUIRE(pattern.has_value());
+    REQUIRE(pattern->count() == 5);
+
+    changes.clear();
+    cells.paste(*pattern, 198, 8, changes);
+    REQUIRE(cells.test(199, 8));
+    REQUIRE_FALSE(cells.test(198, 8));
+    REQUIRE_FALSE(cells.test(199, 9));
+
+    // clipped on the left, the glider's third row lands on cells 0 and 1 of row 2
+    cells.paste(*pattern, -1, 0, changes);
+    REQUIRE(cells.test(0, 0));
+    REQUIRE(cells.test(1, 1));
+    REQUIRE(cells.test(0, 2));
+    REQUIRE(cells.test(1, 2));
+    REQUIRE_FALSE(cells.test(2, 2));
+
+    gol::bit_grid a{ 200, 10 };
+    gol::bit_grid b{ 200, 10 };
+    std::mt19937_64 rng_a{ 7 };
+    std::mt19937_64 rng_b{ 7 };
+    a.randomize(0, 0, 200, 10, 0.5, rng_a, changes);
+    b.randomize(0, 0, 200, 10, 0.5, rng_b, changes);
+    REQUIRE(a.count() > 800);
+    REQUIRE(a.count() < 1200);
+
+    gol::board ba{ 200, 10 };
+    gol::board bb{ 200, 10 };
+    a.copy_to(ba);
+    b.copy_to(bb);
+    REQUIRE(ba == bb);
+}
+
+TEST_CASE("Plaintext patterns")
+{
+    std::istringstream text{ "!Name: blinker\n...\nOOO\n" };
+    auto const pattern = gol::read_pattern(text);
+    REQUIRE(pattern.has_value());
+    REQUIRE(pattern->width() == 3);
+    REQUIRE(pattern->height() == 2);
+    REQUIRE(pattern->test(2, 1));
+
+    std::istringstream garbage{ "hello\n" };
+    REQUIRE_FALSE(gol::read_pattern(garbage).has_value());
+}
+
+TEST_CASE("RLE patterns")
+{
+    // the header is bigger than the cells, 12 is a single run and 2$ skips a row
+    std::istringstream text{ "#N runs\nx = 20, y = 5, rule = B3/S23\n12o$b2o2$3bo!\n" };
+    auto const pattern = gol::read_pattern(text);
+    REQUIRE(pattern.has_value());
+    REQUIRE(pattern->width() == 20);
+    REQUIRE(pattern->height() == 5);
+    REQUIRE(pattern->count() == 12 + 2 + 1);
+    REQUIRE(pattern->test(11, 0));
+    REQUIRE_FALSE(pattern->test(12, 0));
+    REQUIRE_FALSE(pattern->test(0, 1));
+    REQUIRE(pattern->test(2, 1));
+    REQUIRE(pattern->test(3, 3));
+    REQUIRE_FALSE(pattern->test(3, 2));
+
+    // without the '!', and bigger than its header
+    std::istringstream unterminated{ "x = 1, y = 1\n3o\n" };
+    auto const cut = gol::read_pattern(unterminated);
+    REQUIRE(cut.has_value());
+    REQUIRE(cut->width() == 3);
+    REQUIRE(cut->count() == 3);
+
+    std::istringstream bad{ "x = 3, y = 3\nbo?!\n" };
+    REQUIRE_FALSE(gol::read_pattern(bad).has_value());
+
+    // nothing past INT_MAX, be it a run, a header value or where the runs add up to
+    std::istringstream long_run{ "x = 1, y = 1\n9999999999o!\n" };
+    REQUIRE_FALSE(gol::read_pattern(long_run).has_value());
+    std::istringstream wide{ "x = 99999999999, y = 1\no!\n" };
+    REQUIRE_FALSE(gol::read_pattern(wide).has_value());
+    std::istringstream far{ "x = 1, y = 1\n2147483647bo!\n" };
+    REQUIRE_FALSE(gol::read_pattern(far).has_value());
+    std::istringstream low{ "x = 1, y = 1\no2147483647$o!\n" };
+    REQUIRE_FALSE(gol::read_pattern(low).has_value());
+
+    // limited to a size, by the header or by the cells
+    REQUIRE(gol::read_pattern("x = 3, y = 2\n3o!", 3, 2).has_value());
+    REQUIRE_FALSE(gol::read_pattern("x = 3, y = 100000000\no!", 3, 2).has_value());
+    REQUIRE_FALSE(gol::read_pattern("x = 1, y = 1\n4o!", 3, 2).has_value());
+    REQUIRE_FALSE(gol::read_pattern("x = 1, y = 1\n2$o!", 3, 2).has_value());
+    REQUIRE_FALSE(gol::read_pattern("...\n...\n.O.\n", 3, 2).has_value());
+}
+
+TEST_CASE("The census names known objects in every phase and orientation")
+{
+    using counts = std::map<std::string, int>;
+
+    REQUIRE(census_of({ "OO", "OO" }) == counts{ { "block", 1 } });
+    REQUIRE(census_of({ "OOO" }) == counts{ { "blinker", 1 } });
+    REQUIRE(census_of({ "O", "O", "O" }) == counts{ { "blinker", 1 } });
+
+    // the 4 phases of a glider going down and right, then one going up and left
+    REQUIRE(census_of({ ".O.", "..O", "OOO" }) == counts{ { "glider", 1 } });
+    REQUIRE(census_of({ "O.O", ".OO", ".O." }) == counts{ { "glider", 1 } });
+    REQUIRE(census_of({ "..O", "O.O", ".OO" }) == counts{ { "glider", 1 } });
+    REQUIRE(census_of({ "O..", ".OO", "OO." }) == counts{ { "glider", 1 } });
+    REQUIRE(census_of({ "OOO", "O..", ".O." }) == counts{ { "glider", 1 } });
+
+    REQUIRE(census_of({ ".O..O", "O....", "O...O", "OOOO." }) == counts{ { "lwss", 1 } });
+    REQUIRE(census_of({ ".OOO", "O..O", "...O", "...O", "O.O." }) == counts{ { "lwss", 1 } });
+}
+
+TEST_CASE("The census classifies objects it doesn't know by their period")
+{
+    using counts = std::map<std::string, int>;
+
+    // a snake and a clock
+    REQUIRE(census_of({ "OO.O", "O.OO" }) == counts{ { "still life (6 cells)", 1 } });
+    REQUIRE(census_of({ "..O.", "O.O.", ".O.O", ".O.." }) == counts{ { "p2 oscillator (6 cells)", 1 } });
+
+    // remembered as what it turned out to be
+    gol::census c;
+    std::vector<unsigned char> grid(10 * 10, 0);
+    draw(grid, 10, { "OO.O", "O.OO" }, 1, 1);
+    REQUIRE(c.run(grid, 10, 10) == counts{ { "still life (6 cells)", 1 } });
+    REQUIRE(c.run(grid, 10, 10) == counts{ { "still life (6 cells)", 1 } });
+
+    // a blinker under HighLife and under a rule where nothing survives
+    std::vector<unsigned char> blinker(5 * 5, 0);
+    draw(blinker, 5, { "OOO" }, 1, 2);
+    REQUIRE(gol::census{ *gol::parse_rule("B36/S23") }.run(blinker, 5, 5) ==
+            counts{ { "p2 oscillator (3 cells)", 1 } });
+    REQUIRE(gol::census{ *gol::parse_rule("B3/S") }.run(blinker, 5, 5) == counts{ { "unstable (3 cells)", 1 } });
+}
+
+TEST_CASE("The census joins cells up to 2 apart and nothing further")
+{
+    using counts = std::map<std::string, int>;
+
+    // a dead cell between them is still one object, two dead cells, 3 cells apart, make two
+    REQUIRE(census_of({ "OO.OO", "OO.OO" }).count("block") == 0);
+    REQUIRE(census_of({ "OO..OO", "OO..OO" }) == counts{ { "block", 2 } });
+    REQUIRE(census_of({ "OO", "OO", "..", "..", "OO", "OO" }) == counts{ { "block", 2 } });
+
+    // a glider starting on every row, so whatever the bands are some of them cross a border between two
+    constexpr int num_gliders = 60;
+    constexpr int spacing = 6;
+    constexpr int width = num_gliders * spacing;
+    constexpr int height = num_gliders + 2;
+    std::vector<unsigned char> grid(static_cast<std::size_t>(width) * height, 0);
+
+    for(int i = 0; i < num_gliders; ++i) {
+        draw(grid, width, { ".O.", "..O", "OOO" }, i * spacing, i);
+    }
+
+    REQUIRE(gol::census{}.run(grid, width, height) == counts{ { "glider", num_gliders } });
+}
@@ -0,0 +1,78 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "input_script.hpp"
+
+namespace {
+
+[[nodiscard]] auto read(std::string const& text) -> std::optional<std::vector<sdl::input_event>>
+{
+    std::istringstream in{ text };
+    return sdl::read_script(in);
+}
+
+} // namespace
+
+TEST_CASE("Every kind of event reads back as it was written")
+{
+    std::vector<sdl::input_event> events;
+    long frame = 1;
+
+    for(int key = 0; key <= static_cast<int>(sdl::key_event::vk_none); ++key) {
+        events.push_back({ frame++, 0.5, sdl::input_kind::key_press, key, 0 });
+    }
+    for(int kind = static_cast<int>(sdl::input_kind::left_click); kind < static_cast<int>(sdl::input_kind::quit);
+        ++kind) {
+        events.push_back({ frame++, 16.25, static_cast<sdl::input_kind>(kind), 640 + kind, -3 * kind });
+    }
+    events.push_back({ frame, 1000.0, sdl::input_kind::quit, 0, 0 });
+
+    std::ostringstream out;
+    for(auto const& ev : events) {
+        sdl::write_event(out, ev);
+    }
+
+    auto const script = read("# recorded by a test\n\n" + out.str());
+    REQUIRE(script.has_value());
+    REQUIRE(script->size() == events.size());
+
+    for(std::size_t i = 0; i < events.size(); ++i) {
+        auto const& ev = (*script)[i];
+        REQUIRE(ev.frame == events[i].frame);
+        REQUIRE(ev.time_ms == events[i].time_ms);
+        REQUIRE(ev.kind == events[i].kind);
+        REQUIRE(ev.a == events[i].a);
+        REQUIRE(ev.b == events[i].b);
+    }
+}
+
+TEST_CASE("Keys are written by name")
+{
+    std::ostringstream out;
+    sdl::write_event(out, { 7, 2.5, sdl::input_kind::key_press, static_cast<int>(sdl::key_event::vk_space), 0 });
+    sdl::write_event(out, { 8, 3.0, sdl::input_kind::mouse, 10, 20 });
+
+    REQUIRE(out.str() == "7 2.5 key space\n8 3 mouse 10 20\n");
+}
+
+TEST_CASE("Malformed lines fail the whole script")
+{
+    REQUIRE(read("").has_value());
+    REQUIRE(read("# nothing but a comment\n")->empty());
+
+    REQUIRE_FALSE(read("1 0.0 key space\nnonsense\n").has_value());
+    REQUIRE_FALSE(read("x 0.0 quit\n").has_value());
+    REQUIRE_FALSE(read("1 fast quit\n").has_value());
+    REQUIRE_FALSE(read("1 0.0\n").has_value());
+    REQUIRE_FALSE(read("1 0.0 jump 1 2\n").has_value());
+    REQUIRE_FALSE(read("1 0.0 key\n").has_value());
+    REQUIRE_FALSE(read("1 0.0 key enter\n").has_value());
+    REQUIRE_FALSE(read("1 0.0 left_click 5\n").has_value());
+    REQUIRE_FALSE(read("1 0.0 resize wide tall\n").has_value());
+}
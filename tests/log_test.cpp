@@ -0,0 +1,165 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log_message.hpp"
+
+namespace {
+
+[[nodiscard]] auto at(int const ms) -> std::chrono::system_clock::time_point
+{
+    return std::chrono::system_clock::time_point{ std::chrono::milliseconds{ ms } };
+}
+
+} // namespace
+
+TEST_CASE("Levels parse from their names")
+{
+    REQUIRE(logging::parse_level("trace") == logging::level::trace);
+    REQUIRE(logging::parse_level("info") == logging::level::info);
+    REQUIRE(logging::parse_level("warn") == logging::level::warn);
+    REQUIRE(logging::parse_level("error") == logging::level::error);
+    REQUIRE(logging::parse_level("fatal") == logging::level::fatal);
+    REQUIRE(logging::parse_level("off") == logging::level::off);
+
+    REQUIRE_FALSE(logging::parse_level("INFO").has_value());
+    REQUIRE_FALSE(logging::parse_level("verbose").has_value());
+    REQUIRE_FALSE(logging::parse_level("").has_value());
+}
+
+TEST_CASE("Messages keep every kind of argument until they're formatted")
+{
+    enum class color
+    {
+        red,
+        green
+    };
+
+    logging::message m;
+    m.format = "{} {} {} {} {}{} {} {}";
+    logging::append(m, -5);
+    logging::append(m, std::uint64_t{ 7 });
+    logging::append(m, 1.5F);
+    logging::append(m, true);
+    logging::append(m, 'x');
+    logging::append(m, "yz");
+
+    REQUIRE(m.count == 6);
+    REQUIRE(m.args[0].type == logging::argument::kind::signed_integer);
+    REQUIRE(m.args[1].type == logging::argument::kind::unsigned_integer);
+    REQUIRE(m.args[2].type == logging::argument::kind::floating_point);
+    REQUIRE(m.args[3].type == logging::argument::kind::boolean);
+    REQUIRE(m.args[4].type == logging::argument::kind::text);
+    REQUIRE(m.args[5].type == logging::argument::kind::text);
+    REQUIRE(m.text_used == 3);
+
+    // two arguments short of the format
+    REQUIRE(logging::to_text(m).rfind("{} {} {} {} {}{} {} {} (", 0) == 0);
+
+    m.format = "{} {} {} {} {}{}";
+    REQUIRE(logging::to_text(m) == "-5 7 1.5 true xyz");
+
+    logging::message e;
+    e.format = "{} {}";
+    logging::append(e, color::green);
+    logging::append(e, std::string{ "text" });
+    REQUIRE(e.args[0].type == logging::argument::kind::signed_integer);
+    REQUIRE(logging::to_text(e) == "1 text");
+}
+
+TEST_CASE("Text past the message's buffer is cut")
+{
+    logging::message m;
+    m.format = "{}|{}|{}";
+
+    std::string const first(200, 'a');
+    std::string const second(100, 'b');
+    logging::append(m, first);
+    logging::append(m, second);
+    logging::append(m, "c");
+
+    REQUIRE(m.text_used == logging::message::s_text_size);
+    REQUIRE(m.args[1].length == logging::message::s_text_size - first.size());
+    REQUIRE(m.args[2].length == 0);
+    REQUIRE(logging::to_text(m) == first + '|' + std::string(logging::message::s_text_size - first.size(), 'b') + '|');
+}
+
+TEST_CASE("Recorders merge the threads' messages by time")
+{
+    constexpr int per_thread = 200;
+    logging::recorder r;
+    std::atomic<int> dropped{ 0 };
+
+    // one thread records the even milliseconds, the other the odd ones
+    auto const record = [&r, &dropped](int const first) {
+        for(int i = 0; i < per_thread; ++i) {
+            logging::message m;
+            m.time = at(first + 2 * i);
+
+            if(!r.push(m)) {
+                dropped.fetch_add(1);
+            }
+        }
+    };
+
+    std::thread even{ record, 0 };
+    std::thread odd{ record, 1 };
+    even.join();
+    odd.join();
+    REQUIRE(dropped.load() == 0);
+
+    // recorded on this thread at the same time as the first odd one, stays behind it
+    logging::message late;
+    late.time = at(1);
+    late.count = 1;
+    REQUIRE(r.push(late));
+
+    std::vector<logging::message> out;
+    REQUIRE(r.drain(out) == 0);
+    REQUIRE(out.size() == 2 * per_thread + 1);
+
+    for(std::size_t i = 1; i < out.size(); ++i) {
+        REQUIRE(out[i - 1].time <= out[i].time);
+    }
+    REQUIRE(out[1].time == at(1));
+    REQUIRE(out[1].count == 0);
+    REQUIRE(out[2].count == 1);
+
+    out.clear();
+    REQUIRE(r.drain(out) == 0);
+    REQUIRE(out.empty());
+}
+
+TEST_CASE("Recorders count what a full ring dropped")
+{
+    constexpr std::size_t attempts = 600;
+    logging::recorder r;
+    std::size_t recorded = 0;
+
+    for(std::size_t i = 0; i < attempts; ++i) {
+        logging::message m;
+        m.time = at(static_cast<int>(i));
+        recorded += r.push(m) ? 1 : 0;
+    }
+
+    REQUIRE(recorded > 0);
+    REQUIRE(recorded < attempts);
+
+    std::vector<logging::message> out;
+    REQUIRE(r.drain(out) == attempts - recorded);
+    REQUIRE(out.size() == recorded);
+    REQUIRE(out.front().time == at(0));
+
+    // room again, and the count starts over
+    logging::message m;
+    REQUIRE(r.push(m));
+    out.clear();
+    REQUIRE(r.drain(out) == 0);
+    REQUIRE(out.size() == 1);
+}
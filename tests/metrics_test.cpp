@@ -0,0 +1,67 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread/metrics.hpp"
+#include "thread/thread_pool.hpp"
+
+TEST_CASE("Counters add up over every thread")
+{
+    constexpr int num_threads = 8;
+    constexpr int increments = 10000;
+    gol::metric counter{ "test_increments_total", "Increments", gol::metric_kind::counter };
+
+    std::vector<std::thread> threads;
+    for(int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&counter] {
+            for(int j = 0; j < increments; ++j) {
+                counter.increment();
+            }
+        });
+    }
+    for(auto& t : threads) {
+        t.join();
+    }
+
+    REQUIRE(counter.value() == num_threads * increments);
+}
+
+TEST_CASE("Gauges hold the last value and scale when written")
+{
+    gol::metric gauge{ "test_seconds", "Some time", gol::metric_kind::gauge, 1e-3 };
+
+    gauge.set(1500);
+    gauge.move(-250);
+    REQUIRE(gauge.value() == 1250);
+
+    std::ostringstream out;
+    gol::metrics::get().write(out);
+    auto const text = out.str();
+
+    REQUIRE(text.find("# HELP test_seconds Some time\n# TYPE test_seconds gauge\ntest_seconds 1.25\n") !=
+            std::string::npos);
+}
+
+TEST_CASE("Thread pools count their queued tasks")
+{
+    {
+        gol::threadpool tp{ 2 };
+        std::vector<std::future<void>> done;
+
+        for(int i = 0; i < 100; ++i) {
+            done.push_back(tp.push([] {}));
+        }
+        for(auto& d : done) {
+            d.get();
+        }
+    }
+
+    std::ostringstream out;
+    gol::metrics::get().write(out);
+
+    REQUIRE(out.str().find("\ngol_threadpool_queued_tasks 0\n") != std::string::npos);
+}
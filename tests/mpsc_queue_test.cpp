@@ -0,0 +1,76 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "thread/mpsc_queue.hpp"
+
+TEST_CASE("Basic MPSC Queue Test")
+{
+    constexpr int N = 8;
+    gol::mpsc_queue<int, N> q;
+
+    int val = 0;
+    REQUIRE(!q.pop(val));
+
+    for(int i = 0; i < N; ++i) {
+        REQUIRE(q.push(i));
+    }
+    REQUIRE(!q.push(N));
+
+    for(int i = 0; i < N; ++i) {
+        REQUIRE(q.pop(val));
+        REQUIRE(val == i);
+    }
+    REQUIRE(!q.pop(val));
+
+    // wraps around
+    REQUIRE(q.push(N));
+    REQUIRE(q.pop(val));
+    REQUIRE(val == N);
+}
+
+TEST_CASE("MPSC Queue with multiple producers")
+{
+    constexpr int num_producers = 4;
+    constexpr int per_producer = 10000;
+    gol::mpsc_queue<int, 64> q;
+
+    std::vector<std::thread> producers;
+    producers.reserve(num_producers);
+
+    for(int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&q, p] {
+            for(int i = 0; i < per_producer; ++i) {
+                while(!q.push(p * per_producer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> last_seen(num_producers, -1);
+    int received = 0;
+
+    while(received < num_producers * per_producer) {
+        int val = 0;
+        if(!q.pop(val)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // values of a single producer arrive in order
+        auto const producer = static_cast<std::size_t>(val / per_producer);
+        REQUIRE(val % per_producer > last_seen[producer]);
+        last_seen[producer] = val % per_producer;
+        ++received;
+    }
+
+    for(auto& t : producers) {
+        t.join();
+    }
+
+    REQUIRE(std::all_of(last_seen.begin(), last_seen.end(), [](int const v) { return v == per_producer - 1; }));
+}
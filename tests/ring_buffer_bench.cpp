@@ -0,0 +1,117 @@
+// Throughput and round trip latency of gol::ring_buffer between two threads, not run by ctest
+#include "thread/ring_buffer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t g_capacity = 1024;
+constexpr int g_num_messages = 10'000'000;
+constexpr int g_num_round_trips = 100'000;
+
+auto throughput() -> void
+{
+    gol::ring_buffer<int, g_capacity> ring;
+    long long sum = 0;
+
+    auto const start = clock_type::now();
+
+    std::thread consumer{ [&ring, &sum] {
+        int value = 0;
+        for(int i = 0; i < g_num_messages; ++i) {
+            static_cast<void>(ring.pop(value));
+            sum += value;
+        }
+    } };
+
+    for(int i = 0; i < g_num_messages; ++i) {
+        static_cast<void>(ring.push(int{ i }));
+    }
+
+    consumer.join();
+
+    auto const seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    std::cout << "throughput: " << g_num_messages / seconds / 1e6 << " M messages/s (checksum " << sum << ")\n";
+}
+
+// what gol_scene sends every generation
+auto throughput_vectors() -> void
+{
+    constexpr int num_vectors = 100'000;
+    constexpr std::size_t vector_size = 4096;
+
+    gol::ring_buffer<std::vector<int>, 51> ring;
+    std::size_t total = 0;
+
+    auto const start = clock_type::now();
+
+    std::thread consumer{ [&ring, &total] {
+        std::vector<int> value;
+        for(int i = 0; i < num_vectors; ++i) {
+            static_cast<void>(ring.pop(value));
+            total += value.size();
+        }
+    } };
+
+    for(int i = 0; i < num_vectors; ++i) {
+        static_cast<void>(ring.push(std::vector<int>(vector_size, i)));
+    }
+
+    consumer.join();
+
+    auto const seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    std::cout << "vector throughput: " << num_vectors / seconds / 1e3 << " K vectors/s of " << vector_size
+              << " ints (" << total << " ints moved)\n";
+}
+
+auto latency() -> void
+{
+    gol::ring_buffer<clock_type::time_point, g_capacity> ping;
+    gol::ring_buffer<clock_type::time_point, g_capacity> pong;
+
+    std::thread echo{ [&ping, &pong] {
+        clock_type::time_point t;
+        for(int i = 0; i < g_num_round_trips; ++i) {
+            static_cast<void>(ping.pop(t));
+            static_cast<void>(pong.push(std::move(t)));
+        }
+    } };
+
+    std::vector<double> round_trips;
+    round_trips.reserve(g_num_round_trips);
+
+    for(int i = 0; i < g_num_round_trips; ++i) {
+        clock_type::time_point t;
+        static_cast<void>(ping.push(clock_type::now()));
+        static_cast<void>(pong.pop(t));
+        round_trips.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - t).count());
+    }
+
+    echo.join();
+
+    std::sort(round_trips.begin(), round_trips.end());
+
+    auto const at = [&round_trips](double const q) {
+        return round_trips[static_cast<std::size_t>(q * static_cast<double>(round_trips.size() - 1))];
+    };
+
+    std::cout << "round trip latency: p50 " << at(0.5) << " ns, p99 " << at(0.99) << " ns, max " << round_trips.back()
+              << " ns\n";
+}
+
+} // namespace
+
+auto main() -> int
+{
+    throughput();
+    throughput_vectors();
+    latency();
+}
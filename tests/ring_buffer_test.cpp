@@ -3,6 +3,8 @@
 
 #include <algorithm>
 #include <iostream>
+#include <memory>
+#include <thread>
 
 #include "thread/ring_buffer.hpp"
 #include "thread/thread_pool.hpp"
@@ -12,22 +14,22 @@ TEST_CASE("Basic RingBuffer Test")
     constexpr int N = 11;
     gol::ring_buffer<int, N> v;
 
-    REQUIRE(v.push(0));
-    REQUIRE(v.push(1));
-    REQUIRE(v.push(2));
-    REQUIRE(v.push(3));
-    REQUIRE(v.push(4));
-    REQUIRE(v.push(5));
-    REQUIRE(v.push(6));
-    REQUIRE(v.push(7));
-    REQUIRE(v.push(8));
-    REQUIRE(v.push(9));
-    REQUIRE(!v.push(10));
+    REQUIRE(v.try_push(0));
+    REQUIRE(v.try_push(1));
+    REQUIRE(v.try_push(2));
+    REQUIRE(v.try_push(3));
+    REQUIRE(v.try_push(4));
+    REQUIRE(v.try_push(5));
+    REQUIRE(v.try_push(6));
+    REQUIRE(v.try_push(7));
+    REQUIRE(v.try_push(8));
+    REQUIRE(v.try_push(9));
+    REQUIRE(!v.try_push(10));
 
     int val = 0;
 
     for(int i = 0; i < N - 1; ++i) {
-        REQUIRE(v.pop(val));
+        REQUIRE(v.try_pop(val));
         REQUIRE(val == i);
     }
 }
@@ -45,7 +47,7 @@ TEST_CASE("RingBuffer + ThreadPool")
 
         for(int i = 0; i < N - 1; ++i) {
             try {
-                futures.push_back(tp.push([&v, i] { v.push(i + 1); }));
+                futures.push_back(tp.push([&v, i] { v.try_push(i + 1); }));
             }
             catch(std::exception const& e) {
                 MESSAGE("Exception: " << e.what());
@@ -62,7 +64,7 @@ TEST_CASE("RingBuffer + ThreadPool")
 
     for(int i = 0; i < N - 1; ++i) {
         int val = 0;
-        REQUIRE(v.pop(val));
+        REQUIRE(v.try_pop(val));
         numbers.push_back(val);
     }
 
@@ -72,3 +74,61 @@ TEST_CASE("RingBuffer + ThreadPool")
         REQUIRE(numbers[i] == i + 1);
     }
 }
+
+TEST_CASE("RingBuffer with move only elements")
+{
+    gol::ring_buffer<std::unique_ptr<int>, 4> v;
+
+    REQUIRE(v.try_push(std::make_unique<int>(1)));
+    REQUIRE(v.try_emplace(new int{ 2 }));
+    REQUIRE(v.push(std::make_unique<int>(3)));
+    REQUIRE(!v.try_push(std::make_unique<int>(4)));
+
+    std::unique_ptr<int> val;
+
+    for(int i = 1; i <= 3; ++i) {
+        REQUIRE(v.try_pop(val));
+        REQUIRE(*val == i);
+    }
+    REQUIRE(!v.try_pop(val));
+
+    // whatever is left is destroyed with the buffer
+    REQUIRE(v.try_push(std::make_unique<int>(5)));
+}
+
+TEST_CASE("RingBuffer blocking push and pop")
+{
+    constexpr int N = 4;
+    constexpr int count = 100000;
+    gol::ring_buffer<int, N> v;
+
+    std::thread producer{ [&v] {
+        for(int i = 0; i < count; ++i) {
+            REQUIRE(v.push(int{ i }));
+        }
+    } };
+
+    for(int i = 0; i < count; ++i) {
+        int val = -1;
+        REQUIRE(v.pop(val));
+        REQUIRE(val == i);
+    }
+
+    producer.join();
+}
+
+TEST_CASE("Closing a RingBuffer wakes up blocked threads")
+{
+    gol::ring_buffer<int, 2> v;
+    REQUIRE(v.try_push(1));
+
+    std::thread producer{ [&v] { REQUIRE(!v.push(2)); } };
+
+    v.close();
+    producer.join();
+
+    int val = 0;
+    REQUIRE(v.try_pop(val));
+    REQUIRE(val == 1);
+    REQUIRE(!v.pop(val));
+}
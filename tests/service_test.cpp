@@ -0,0 +1,217 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <sys/socket.h>
+
+#include <array>
+#include <climits>
+#include <sstream>
+#include <string>
+
+#include "service.hpp"
+#include "socket.hpp"
+
+#include "engine/board.hpp"
+#include "thread/metrics.hpp"
+
+namespace {
+
+constexpr auto s_glider = "x = 3, y = 3\nbob$2bo$3o!\n";
+
+// a client talking straight to service::execute() over a socket pair, as the client's thread would
+class client
+{
+private:
+    gol::service& m_service;
+    gol::socket m_server;
+    gol::socket m_peer;
+    std::string m_buffered;
+
+public:
+    explicit client(gol::service& s)
+        : m_service{ s }
+    {
+        std::array<int, 2> fds{};
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) == 0);
+
+        m_server = gol::socket{ fds[0] };
+        m_peer = gol::socket{ fds[1] };
+    }
+
+    auto operator()(std::string const& line) -> std::string
+    {
+        return m_service.execute(line, m_server, m_buffered);
+    }
+
+    auto load(std::string const& session, int const x, int const y, std::string const& pattern) -> std::string
+    {
+        REQUIRE(m_peer.send(pattern));
+        return (*this)("load " + session + ' ' + std::to_string(x) + ' ' + std::to_string(y) + ' ' +
+                       std::to_string(pattern.size()));
+    }
+
+    // sends `bytes` but says there are `size`, then hangs up
+    auto load_cut_off(std::string const& session, std::string const& bytes, std::size_t const size) -> std::string
+    {
+        REQUIRE(m_peer.send(bytes));
+        m_peer.close();
+        return (*this)("load " + session + " 0 0 " + std::to_string(size));
+    }
+};
+
+// the id in an `ok <session>` answer
+[[nodiscard]] auto session_of(std::string const& answer) -> std::string
+{
+    REQUIRE(answer.rfind("ok ", 0) == 0);
+    return answer.substr(3, answer.size() - 4);
+}
+
+[[nodiscard]] auto metric_value(std::string const& name) -> long
+{
+    std::ostringstream out;
+    gol::metrics::get().write(out);
+    auto const text = out.str();
+
+    auto const at = text.find('\n' + name + ' ');
+    REQUIRE(at != std::string::npos);
+
+    return std::stol(text.substr(at + name.size() + 2));
+}
+
+} // namespace
+
+TEST_CASE("Cells are packed eight to a byte, low bit first, with rows padded to a byte")
+{
+    gol::board b{ 10, 2 };
+    b.at(0, 0) = gol::board::s_alive;
+    b.at(9, 0) = gol::board::s_alive;
+    b.at(3, 1) = gol::board::s_alive;
+
+    REQUIRE(gol::pack_cells(b, 0, 0, 10, 2) == std::string{ '\x01', '\x02', '\x08', '\x00' });
+    REQUIRE(gol::pack_cells(b, 1, 0, 9, 1) == std::string{ '\x00', '\x01' });
+    REQUIRE(gol::pack_cells(b, 0, 0, 0, 2).empty());
+}
+
+TEST_CASE("Sessions are created, loaded, stepped, read, copied and closed")
+{
+    gol::service service{ gol::rule{}, gol::topology::bounded, 2 };
+    client c{ service };
+
+    auto const id = session_of(c("create 8 8"));
+    REQUIRE(c.load(id, 1, 1, s_glider) == "ok\n");
+
+    gol::board expected{ 8, 8 };
+    expected.at(2, 1) = gol::board::s_alive;
+    expected.at(3, 2) = gol::board::s_alive;
+    expected.at(1, 3) = gol::board::s_alive;
+    expected.at(2, 3) = gol::board::s_alive;
+    expected.at(3, 3) = gol::board::s_alive;
+
+    REQUIRE(c("hash " + id) == "ok " + std::to_string(expected.hash()) + '\n');
+    REQUIRE(c("read " + id + " 0 0 8 5") == std::string{ "ok 5\n\x00\x04\x08\x0e\x00", 10 });
+
+    auto const copy = session_of(c("snapshot " + id));
+    REQUIRE(copy != id);
+
+    // a glider moves one cell diagonally every 4 generations
+    REQUIRE(c("step " + id + " 4") == "ok 4\n");
+    REQUIRE(c("read " + id + " 0 2 8 3") == std::string{ "ok 3\n\x08\x10\x1c", 8 });
+    REQUIRE(c("step " + id + " 0") == "ok 4\n");
+
+    // the copy kept the board as it was
+    REQUIRE(c("hash " + copy) == "ok " + std::to_string(expected.hash()) + '\n');
+    REQUIRE(c("step " + copy + " 4") == "ok 4\n");
+    REQUIRE(c("hash " + copy) == c("hash " + id));
+
+    REQUIRE(c("close " + id) == "ok\n");
+    REQUIRE(c("hash " + id) == "error unknown session " + id + '\n');
+    REQUIRE(c("hash " + copy).rfind("ok ", 0) == 0);
+}
+
+TEST_CASE("Bad commands get an error and leave the sessions as they were")
+{
+    gol::service service{ gol::rule{}, gol::topology::bounded, 1 };
+    client c{ service };
+
+    auto const id = session_of(c("create 16 8"));
+    auto const empty = c("hash " + id);
+
+    REQUIRE(c("hash 99") == "error unknown session 99\n");
+    REQUIRE(c("step " + id + " 1 99 1") == "error unknown session 99\n");
+    REQUIRE(c("step " + id + " -1").rfind("error usage: step", 0) == 0);
+    REQUIRE(c("step " + id).rfind("error usage: step", 0) == 0);
+    REQUIRE(c("step " + id + " x").rfind("error usage: step", 0) == 0);
+    REQUIRE(c("create 0 8").rfind("error usage: create", 0) == 0);
+    REQUIRE(c("create 8 8 B3/S23 sphere") == "error unknown topology sphere\n");
+    REQUIRE(c("frobnicate") == "error unknown command frobnicate\n");
+
+    REQUIRE(c("read " + id + " 0 0 17 8") == "error the region is outside the board\n");
+    REQUIRE(c("read " + id + " 8 4 8 5") == "error the region is outside the board\n");
+    REQUIRE(c("read " + id + " 2147483647 0 1 1") == "error the region is outside the board\n");
+
+    // a pattern far outside the board, where the clipping can't overflow
+    REQUIRE(c.load(id, INT_MAX, INT_MAX, s_glider) == "ok\n");
+    REQUIRE(c.load(id, INT_MIN, INT_MIN, s_glider) == "ok\n");
+    REQUIRE(c("hash " + id) == empty);
+    REQUIRE(c("step " + id + " 0") == "ok 0\n");
+
+    REQUIRE(c.load_cut_off(id, "x = 3", 100) == "error the pattern was cut off\n");
+    REQUIRE(c("hash " + id) == empty);
+}
+
+TEST_CASE("Patterns are no bigger than the board they're loaded into")
+{
+    gol::service service{ gol::rule{}, gol::topology::bounded, 1 };
+    client c{ service };
+
+    auto const id = session_of(c("create 16 8"));
+    auto const too_big = std::string{ "error could not read the pattern, or it's bigger than the board\n" };
+
+    // a run past INT_MAX, and sizes that would take far more than the board
+    REQUIRE(c.load(id, 0, 0, "x = 1, y = 1\n9999999999o!") == too_big);
+    REQUIRE(c.load(id, 0, 0, "x = 1, y = 100000000\no!") == too_big);
+    REQUIRE(c.load(id, 0, 0, "x = 1, y = 1\n17o!") == too_big);
+    REQUIRE(c.load(id, 0, 0, "x = 1, y = 1\n8$o!") == too_big);
+
+    // the commands after them are read from where they should be
+    REQUIRE(c.load(id, 0, 0, "x = 16, y = 8\n16o7$16o!") == "ok\n");
+    REQUIRE(c("read " + id + " 0 7 16 1") == std::string{ "ok 2\n\xff\xff", 7 });
+}
+
+TEST_CASE("Sessions aren't created past the memory limit")
+{
+    auto const per_session = 2 * gol::board::memory_usage(16, 16);
+    gol::service service{ gol::rule{}, gol::topology::bounded, 1, 2 * per_session };
+    client c{ service };
+
+    auto const first = session_of(c("create 16 16"));
+    auto const second = session_of(c("snapshot " + first));
+
+    REQUIRE(c("create 16 16") == "error out of memory, --max-memory is reached\n");
+    REQUIRE(c("snapshot " + first) == "error out of memory, --max-memory is reached\n");
+    // the pattern's grid counts too
+    REQUIRE(c.load(first, 0, 0, s_glider) == "error out of memory, --max-memory is reached\n");
+
+    // closing one gives its memory back
+    REQUIRE(c("close " + second) == "ok\n");
+    REQUIRE(c.load(first, 0, 0, s_glider) == "ok\n");
+    REQUIRE(c("create 16 16").rfind("ok ", 0) == 0);
+}
+
+TEST_CASE("Steps sent together run in one batch and answer in request order")
+{
+    gol::service service{ gol::rule{}, gol::topology::torus, 2 };
+    client c{ service };
+
+    auto const a = session_of(c("create 32 32"));
+    auto const b = session_of(c("create 16 16"));
+    REQUIRE(c.load(a, 0, 0, s_glider) == "ok\n");
+    REQUIRE(c.load(b, 4, 4, s_glider) == "ok\n");
+
+    auto const batches = metric_value("gol_service_batches_total");
+    REQUIRE(c("step " + a + " 3 " + b + " 5") == "ok 3 5\n");
+    REQUIRE(metric_value("gol_service_batches_total") == batches + 1);
+
+    // a session's later requests see its earlier ones done
+    REQUIRE(c("step " + a + " 2 " + a + " 0 " + b + " 1") == "ok 5 5 6\n");
+}
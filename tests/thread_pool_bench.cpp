@@ -0,0 +1,124 @@
+// Heap allocations per task and tasks per second through gol::threadpool, not run by ctest
+#include "thread/thread_pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{ 0 };
+
+} // namespace
+
+auto operator new(std::size_t const size) -> void*
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if(void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+auto operator delete(void* ptr) noexcept -> void
+{
+    std::free(ptr);
+}
+
+auto operator delete(void* ptr, std::size_t) noexcept -> void
+{
+    std::free(ptr);
+}
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int g_num_tasks = 200'000;
+constexpr int g_batch = 1000;
+
+template<typename Submit>
+auto measure(char const* name, Submit submit) -> void
+{
+    // warm up so the queue and the slab are at their high-water mark
+    submit();
+
+    auto const allocations = g_allocations.load();
+    auto const start = clock_type::now();
+
+    for(int i = 0; i < g_num_tasks / g_batch; ++i) {
+        submit();
+    }
+
+    auto const seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    auto const per_task = static_cast<double>(g_allocations.load() - allocations) / g_num_tasks;
+
+    std::cout << name << ": " << per_task << " allocations/task, " << g_num_tasks / seconds / 1e6
+              << " M tasks/s\n";
+}
+
+} // namespace
+
+auto main() -> int
+{
+    gol::threadpool tp{ 4 };
+    std::atomic<long long> sum{ 0 };
+    std::vector<std::future<void>> futures;
+    futures.reserve(g_batch);
+
+    auto const work = [&sum](int const x) { sum.fetch_add(x, std::memory_order_relaxed); };
+
+    // what push() used to do: a shared packaged_task wrapped in a std::function
+    measure("shared packaged_task + std::function", [&] {
+        futures.clear();
+        for(int i = 0; i < g_batch; ++i) {
+            auto t = std::make_shared<std::packaged_task<void()>>(std::bind(work, i));
+            futures.push_back(t->get_future());
+            tp.post(std::function<void()>{ [t] { (*t)(); } });
+        }
+        for(auto& f : futures) {
+            f.get();
+        }
+    });
+
+    measure("push + future", [&] {
+        futures.clear();
+        for(int i = 0; i < g_batch; ++i) {
+            futures.push_back(tp.push(work, i));
+        }
+        for(auto& f : futures) {
+            f.get();
+        }
+    });
+
+    measure("task_group", [&] {
+        gol::task_group group{ tp };
+        for(int i = 0; i < g_batch; ++i) {
+            group.run([&work, i] { work(i); });
+        }
+        group.wait();
+    });
+
+    std::array<long long, 16> payload{};
+    measure("task_group, 128 byte captures", [&] {
+        gol::task_group group{ tp };
+        for(int i = 0; i < g_batch; ++i) {
+            group.run([&work, i, payload] { work(i + static_cast<int>(payload[0])); });
+        }
+        group.wait();
+    });
+
+    std::cout << "slab refills: " << gol::task::slab_refills() << '\n';
+
+    return sum.load() == 0 ? 1 : 0;
+}
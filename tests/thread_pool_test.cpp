@@ -0,0 +1,195 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "thread/thread_pool.hpp"
+
+TEST_CASE("parallel_for visits every index once")
+{
+    constexpr std::size_t N = 10007;
+    gol::threadpool tp{ 4 };
+
+    for(auto const s : { gol::schedule::static_chunks, gol::schedule::dynamic_chunks }) {
+        std::vector<std::atomic<int>> visits(N);
+
+        tp.parallel_for(
+            3,
+            N,
+            64,
+            [&visits](std::size_t const begin, std::size_t const end) {
+                for(std::size_t i = begin; i < end; ++i) {
+                    visits[i].fetch_add(1);
+                }
+            },
+            s);
+
+        for(std::size_t i = 0; i < N; ++i) {
+            REQUIRE(visits[i].load() == (i < 3 ? 0 : 1));
+        }
+    }
+}
+
+TEST_CASE("Static chunks go to the worker with their index")
+{
+    constexpr std::size_t num_workers = 4;
+    gol::threadpool tp{ num_workers };
+
+    for(int round = 0; round < 2; ++round) {
+        std::vector<std::size_t> workers(num_workers, gol::threadpool::s_not_a_worker);
+        std::atomic<std::size_t> arrived{ 0 };
+
+        // every chunk waits for the others, so each worker takes exactly one and finds its own still unclaimed
+        tp.parallel_for(
+            0,
+            num_workers,
+            1,
+            [&workers, &arrived](std::size_t const begin, std::size_t) {
+                arrived.fetch_add(1);
+                while(arrived.load() < num_workers) {
+                    std::this_thread::yield();
+                }
+                workers[begin] = gol::threadpool::current_worker();
+            },
+            gol::schedule::static_chunks);
+
+        for(std::size_t i = 0; i < num_workers; ++i) {
+            REQUIRE(workers[i] == i);
+        }
+    }
+
+    REQUIRE(gol::threadpool::current_worker() == gol::threadpool::s_not_a_worker);
+}
+
+TEST_CASE("Task groups wait for all their tasks and rethrow")
+{
+    gol::threadpool tp{ 2 };
+    std::atomic<int> count{ 0 };
+
+    {
+        gol::task_group group{ tp };
+
+        for(int i = 0; i < 100; ++i) {
+            group.run([&count] { count.fetch_add(1); });
+        }
+
+        group.wait();
+        REQUIRE(count.load() == 100);
+
+        group.run([] { throw std::runtime_error{ "task failed" }; });
+        group.run([&count] { count.fetch_add(1); });
+
+        bool thrown = false;
+        try {
+            group.wait();
+        }
+        catch(std::runtime_error const&) {
+            thrown = true;
+        }
+
+        REQUIRE(thrown);
+        REQUIRE(count.load() == 101);
+    }
+}
+
+TEST_CASE("Pinned thread pools run each worker on its own CPU")
+{
+    constexpr std::size_t num_workers = 2;
+    gol::threadpool tp{ num_workers, true };
+    REQUIRE(tp.size() == num_workers);
+    REQUIRE(tp.push([] { return 42; }).get() == 42);
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    auto const num_cpus = std::max(1U, std::thread::hardware_concurrency());
+    std::vector<std::atomic<int>> checked(num_workers);
+    std::atomic<std::size_t> arrived{ 0 };
+
+    tp.parallel_for(
+        0,
+        num_workers,
+        1,
+        [&](std::size_t, std::size_t) {
+            arrived.fetch_add(1);
+            while(arrived.load() < num_workers) {
+                std::this_thread::yield();
+            }
+
+            auto const worker = gol::threadpool::current_worker();
+            auto const cpu = static_cast<int>(worker % num_cpus);
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+
+            // a CPU the process isn't allowed on can't be pinned to, the worker keeps the process's CPUs
+            checked[worker] = CPU_ISSET(cpu, &allowed) ? (CPU_COUNT(&set) == 1 && CPU_ISSET(cpu, &set) ? 1 : -1) : 2;
+        },
+        gol::schedule::static_chunks);
+
+    for(auto const& c : checked) {
+        REQUIRE(c.load() > 0);
+    }
+#endif
+}
+
+TEST_CASE("Tasks keep small, big and move-only captures")
+{
+    int small = 0;
+    gol::task a{ [&small] { ++small; } };
+
+    std::array<long long, 32> big{};
+    big.back() = 42;
+    long long seen = 0;
+    gol::task b{ [big, &seen] { seen = big.back(); } };
+
+    auto owned = std::make_unique<int>(7);
+    int moved = 0;
+    gol::task c{ [owned = std::move(owned), &moved] { moved = *owned; } };
+
+    gol::task d{ std::move(b) };
+    REQUIRE(!b);
+    REQUIRE(static_cast<bool>(d));
+
+    a();
+    d();
+    c = gol::task{ std::move(c) };
+    c();
+
+    REQUIRE(small == 1);
+    REQUIRE(seen == 42);
+    REQUIRE(moved == 7);
+}
+
+TEST_CASE("task_group and push run everything")
+{
+    constexpr int N = 1000;
+    gol::threadpool tp{ 4 };
+    std::atomic<int> sum{ 0 };
+
+    {
+        gol::task_group group{ tp };
+        for(int i = 0; i < N; ++i) {
+            group.run([&sum, i] { sum.fetch_add(i); });
+        }
+        group.wait();
+    }
+
+    REQUIRE(sum.load() == N * (N - 1) / 2);
+    REQUIRE(tp.push([](int x) { return x * 2; }, 21).get() == 42);
+}
@@ -0,0 +1,66 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <array>
+#include <thread>
+
+#include "thread/triple_buffer.hpp"
+
+TEST_CASE("Basic TripleBuffer Test")
+{
+    gol::triple_buffer<int> b{ 0 };
+
+    REQUIRE(!b.update());
+    REQUIRE(b.front() == 0);
+
+    b.back() = 1;
+    b.publish();
+    b.back() = 2;
+    b.publish();
+
+    // only the newest one is seen
+    REQUIRE(b.update());
+    REQUIRE(b.front() == 2);
+    REQUIRE(!b.update());
+    REQUIRE(b.front() == 2);
+
+    b.back() = 3;
+    b.publish();
+    REQUIRE(b.update());
+    REQUIRE(b.front() == 3);
+
+    b.reset(4);
+    REQUIRE(!b.update());
+    REQUIRE(b.front() == 4);
+    REQUIRE(b.back() == 4);
+}
+
+TEST_CASE("TripleBuffer readers see whole buffers in order")
+{
+    constexpr int count = 100000;
+    gol::triple_buffer<std::array<int, 16>> b{ std::array<int, 16>{} };
+
+    std::thread writer{ [&b] {
+        for(int i = 1; i <= count; ++i) {
+            b.back().fill(i);
+            b.publish();
+        }
+    } };
+
+    int last = 0;
+
+    while(last != count) {
+        if(!b.update()) {
+            continue;
+        }
+
+        auto const& front = b.front();
+        REQUIRE(front[0] > last);
+        for(auto const value : front) {
+            REQUIRE(value == front[0]);
+        }
+        last = front[0];
+    }
+
+    writer.join();
+}